@@ -0,0 +1,56 @@
+/*
+ * AllocationTracker.h - find heap usage of render threads
+ *
+ * Copyright (c) 2014 Tobias Doerffel <tobydox/at/users.sourceforge.net>
+ *
+ * This file is part of Linux MultiMedia Studio - http://lmms.sourceforge.net
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef _ALLOCATION_TRACKER_H
+#define _ALLOCATION_TRACKER_H
+
+#include "export.h"
+
+
+/*! \brief Records call sites of malloc()/free() on render threads
+ *
+ * Only does something if LMMS was configured with WANT_DEBUG_ALLOCATIONS
+ * (glibc only). malloc(), calloc(), realloc() and free() are replaced then
+ * and every call made by a render thread while a period is being rendered
+ * gets its backtrace recorded, so heap usage sneaking into the render path
+ * is noticed before it causes xruns.
+ */
+class EXPORT AllocationTracker
+{
+public:
+	/*! \brief Mark calling thread as render thread */
+	static void registerRenderThread();
+
+	/*! \brief Called by Mixer::renderNextBuffer() around each period -
+	 * registers calling thread as well */
+	static void beginPeriod();
+	static void endPeriod();
+
+	/*! \brief Print all distinct call sites recorded so far */
+	static void report();
+
+} ;
+
+
+#endif
@@ -39,6 +39,37 @@ class AudioPort;
 class AudioDevice
 {
 public:
+	// how well the device got supplied with periods - updated while
+	// processing, may be read from any thread
+	struct Statistics
+	{
+		enum
+		{
+			// render time in steps of 10% of period length, last
+			// bin counts periods which took longer than that
+			RenderTimeBins = 11
+		} ;
+
+		Statistics();
+
+		void reset();
+
+		// human readable multi-line summary
+		QString summary() const;
+
+		// periods fetched from mixer
+		AtomicInt periods;
+		// buffer underruns reported by driver or sound server
+		AtomicInt underruns;
+		// periods which were not ready before their deadline
+		AtomicInt latePeriods;
+		AtomicInt renderTime[RenderTimeBins];
+		// time (in microseconds) left until deadline when period
+		// was available
+		AtomicInt minSlack;
+		AtomicInt averageSlack;
+	} ;
+
 	AudioDevice( const ch_cnt_t _channels, Mixer* mixer );
 	virtual ~AudioDevice();
 
@@ -89,6 +120,21 @@ public:
 	virtual void applyQualitySettings();
 
 
+	inline const Statistics & statistics() const
+	{
+		return m_statistics;
+	}
+
+	// called by mixer after rendering a period
+	void recordRenderTime( int _usecs, int _periodLength );
+
+	// called by drivers when they ran out of data
+	inline void reportUnderrun()
+	{
+		m_statistics.underruns.fetchAndAddOrdered( 1 );
+	}
+
+
 
 	class setupWidget : public tabWidget
 	{
@@ -177,6 +223,8 @@ private:
 
 	surroundSampleFrame * m_buffer;
 
+	Statistics m_statistics;
+
 } ;
 
 
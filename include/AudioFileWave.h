@@ -74,10 +74,19 @@ private:
 	bool startEncoding();
 	void finishEncoding();
 
+	// make sure conversion buffer holds at least _frames frames
+	void reserveBuffer( const fpp_t _frames );
+
 
 	SF_INFO m_si;
 	SNDFILE * m_sf;
 
+	// buffer for converted samples, allocated in advance so writing a
+	// period doesn't need to allocate memory
+	fpp_t m_bufferFrames;
+	float * m_floatBuffer;
+	int_sample_t * m_intBuffer;
+
 } ;
 
 
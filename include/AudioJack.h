@@ -34,6 +34,7 @@
 #include <QtCore/QVector>
 #include <QtCore/QList>
 #include <QtCore/QMap>
+#include <QtCore/QSemaphore>
 
 #include "AudioDevice.h"
 
@@ -92,6 +93,7 @@ private:
 	static int staticProcessCallback( jack_nframes_t _nframes,
 							void * _udata );
 	static void shutdownCallback( void * _udata );
+	static int xrunCallback( void * _udata );
 
 
 	jack_client_t * m_client;
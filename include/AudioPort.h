@@ -109,6 +109,13 @@ public:
 
 	bool processEffects();
 
+	// time spent rendering everything playing through this port
+	// (notes, instrument, effects) in last period
+	inline const ProfilerNode & profile() const
+	{
+		return m_profile;
+	}
+
 
 	enum bufferUsages
 	{
@@ -129,13 +136,27 @@ private:
 	bool m_extOutputEnabled;
 	fx_ch_t m_nextFxChannel;
 
+	// index of job processing this port in render-graph of current period
+	int m_renderJob;
+	// whether first buffer has to be mixed into FX channel, which then
+	// calls nextPeriod()
+	volatile bool m_hasOutput;
+	// next input of the FX channel this port is routed to
+	AudioPort * m_nextFxInput;
+	// time (in microseconds) processing this port took in previous period
+	int m_renderCost;
+	ProfilerNode m_profile;
+
 	QString m_name;
+	// copy of name in render tracer
+	int m_traceName;
 	
 	EffectChain * m_effects;
 
 
 	friend class Mixer;
 	friend class MixerWorkerThread;
+	friend class FxMixer;
 
 } ;
 
@@ -26,6 +26,7 @@
 #define _AUDIO_PORTAUDIO_H
 
 #include <QtCore/QObject>
+#include <QtCore/QSemaphore>
 
 #include "lmmsconfig.h"
 #include "ComboBoxModel.h"
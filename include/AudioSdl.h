@@ -32,6 +32,8 @@
 #include <SDL/SDL.h>
 #include <SDL/SDL_audio.h>
 
+#include <QtCore/QSemaphore>
+
 #include "AudioDevice.h"
 
 class QLineEdit;
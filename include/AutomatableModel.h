@@ -128,6 +128,14 @@ public:
 
 	float controllerValue( int frameOffset ) const;
 
+	// values for every frame of current period if automation changes
+	// this model within the period, NULL otherwise - value() is the same
+	// for the whole period then
+	inline const float * valueBuffer() const
+	{
+		return m_valueBufferPeriod == s_period ? m_valueBuffer : NULL;
+	}
+
 
 	template<class T>
 	inline T initValue() const
@@ -162,6 +170,12 @@ public:
 	void setInitValue( const float value );
 
 	void setAutomatedValue( const float value );
+	// set values of frames starting at given one up to end of current
+	// period - value() becomes the last one
+	void setAutomatedValues( const float * values, const f_cnt_t from );
+	// allocate buffer for setAutomatedValues() - called when model gets
+	// automated, so the render thread never has to
+	void prepareValueBuffer();
 	void setValue( const float value );
 
 	inline void incValue( int steps )
@@ -188,6 +202,18 @@ public:
 		m_centerValue = centerVal;
 	}
 
+	// value buffers of all models become outdated - called by mixer at
+	// start of every period
+	static void nextPeriod()
+	{
+		++s_period;
+	}
+
+	static int period()
+	{
+		return s_period;
+	}
+
 	static void linkModels( AutomatableModel* m1, AutomatableModel* m2 );
 	static void unlinkModels( AutomatableModel* m1, AutomatableModel* m2 );
 
@@ -265,8 +291,13 @@ private:
 
 	ControllerConnection* m_controllerConnection;
 
+	// allocated by prepareValueBuffer()
+	float* m_valueBuffer;
+	int m_valueBufferPeriod;
+
 
 	static float s_copiedValue;
+	static int s_period;
 
 
 signals:
@@ -123,7 +123,12 @@ public:
 		return classNodeName();
 	}
 
-	void processMidiTime( const MidiTime & _time );
+	// set automated models for frames _from to end of current period -
+	// frame _frame_base is at position _pos of pattern, values don't
+	// change after _end anymore; _values is used as scratch buffer
+	void processPeriod( const MidiTime & _pos, const f_cnt_t _frame_base,
+				const f_cnt_t _from, const MidiTime & _end,
+							float * _values );
 
 	virtual trackContentObjectView * createView( trackView * _tv );
 
@@ -27,6 +27,8 @@
 #ifndef _AUTOMATION_TRACK_H
 #define _AUTOMATION_TRACK_H
 
+#include <QtCore/QVector>
+
 #include "track.h"
 
 
@@ -36,7 +38,7 @@ public:
 	AutomationTrack( TrackContainer* tc, bool _hidden = false );
 	virtual ~AutomationTrack();
 
-	virtual bool play( const MidiTime & _start, const fpp_t _frames,
+	virtual bool play( const MidiTime & _start, const MidiTime & _end,
 						const f_cnt_t _frame_base, int _tco_num = -1 );
 
 	virtual QString nodeName() const
@@ -52,6 +54,11 @@ public:
 	virtual void loadTrackSpecificSettings( const QDomElement & _this );
 
 private:
+	// values of current period, computed by patterns
+	QVector<float> m_values;
+	// period we've been played in last time
+	int m_lastPeriod;
+
 	friend class AutomationTrackView;
 
 } ;
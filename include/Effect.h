@@ -35,6 +35,7 @@
 
 class EffectChain;
 class EffectControls;
+class PlanarBuffer;
 
 
 class EXPORT Effect : public Plugin
@@ -57,6 +58,20 @@ public:
 	virtual bool processAudioBuffer( sampleFrame * _buf,
 						const fpp_t _frames ) = 0;
 
+	// effects working on separate channels anyway can return true here
+	// and implement processPlanarBuffer() - EffectChain then saves
+	// converting the buffer for them
+	virtual bool supportsPlanarBuffers() const
+	{
+		return false;
+	}
+
+	virtual bool processPlanarBuffer( PlanarBuffer & _buf,
+						const fpp_t _frames )
+	{
+		return false;
+	}
+
 	inline ch_cnt_t processorCount() const
 	{
 		return m_processors;
@@ -152,6 +167,12 @@ public:
 		return m_key;
 	}
 
+	// time spent in processAudioBuffer() in last period
+	inline const ProfilerNode & profile() const
+	{
+		return m_profile;
+	}
+
 	virtual EffectControls * controls() = 0;
 
 	static Effect * instantiate( const QString & _plugin_name,
@@ -211,6 +232,8 @@ private:
 	SRC_DATA m_srcData[2];
 	SRC_STATE * m_srcState[2];
 
+	ProfilerNode m_profile;
+
 
 	friend class EffectView;
 	friend class EffectChain;
@@ -30,6 +30,7 @@
 #include "SerializingObject.h"
 #include "Mixer.h"
 #include "AutomatableModel.h"
+#include "PlanarBuffer.h"
 
 class Effect;
 
@@ -57,6 +58,9 @@ public:
 	void startRunning();
 	bool isRunning();
 
+	// publish time each effect took in current period
+	void finishProfilingPeriod();
+
 	void clear();
 
 	void setEnabled( bool _on )
@@ -67,10 +71,18 @@ public:
 
 private:
 	typedef QVector<Effect *> EffectList;
+
+	// replace m_effects at start of next period - returns after that
+	void setEffects( const EffectList & _effects );
+
 	EffectList m_effects;
 
 	BoolModel m_enabledModel;
 
+	// holds signal while it's passed between effects supporting planar
+	// buffers
+	PlanarBuffer m_planarBuffer;
+
 
 	friend class EffectRackView;
 
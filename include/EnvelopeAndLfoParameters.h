@@ -118,6 +118,8 @@ protected:
 
 
 private:
+	class SampleVarsCommand;
+
 	static LfoInstances * s_lfoInstances;
 	bool m_used;
 
@@ -176,6 +178,7 @@ private:
 
 
 	friend class EnvelopeAndLfoView;
+	friend class SampleVarsCommand;
 	friend class FlpImport;
 
 } ;
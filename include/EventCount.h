@@ -0,0 +1,73 @@
+/*
+ * EventCount.h - lets threads sleep until an event happens without lost wake-ups
+ *
+ * Copyright (c) 2014 Tobias Doerffel <tobydox/at/users.sourceforge.net>
+ *
+ * This file is part of Linux MultiMedia Studio - http://lmms.sourceforge.net
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef _EVENT_COUNT_H
+#define _EVENT_COUNT_H
+
+#include "lmmsconfig.h"
+#include "atomic_int.h"
+
+#ifndef LMMS_BUILD_LINUX
+#include <QtCore/QMutex>
+#include <QtCore/QWaitCondition>
+#endif
+
+
+/*! \brief Sleep until some condition becomes true without losing wake-ups
+ *
+ * A thread waiting for a condition calls prepareWait(), checks the
+ * condition again and then calls either cancelWait() (condition became
+ * true meanwhile) or wait() with the key returned by prepareWait(). A thread
+ * making the condition true calls notifyAll() afterwards. wait() returns
+ * immediately if notifyAll() has been called since prepareWait(), so no
+ * wake-up can get lost.
+ *
+ * notifyAll() is cheap as long as nobody is sleeping. On Linux sleeping is
+ * done via futexes, everywhere else a QWaitCondition is used.
+ */
+class EventCount
+{
+public:
+	EventCount();
+
+	int prepareWait();
+	void cancelWait();
+	void wait( int _key );
+
+	void notifyAll();
+
+
+private:
+	volatile int m_seq;
+	AtomicInt m_waiters;
+
+#ifndef LMMS_BUILD_LINUX
+	QMutex m_mutex;
+	QWaitCondition m_cond;
+#endif
+
+} ;
+
+
+#endif
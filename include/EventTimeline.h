@@ -0,0 +1,134 @@
+/*
+ * EventTimeline.h - events of a track flattened to song positions
+ *
+ * Copyright (c) 2014 Tobias Doerffel <tobydox/at/users.sourceforge.net>
+ *
+ * This file is part of Linux MultiMedia Studio - http://lmms.sourceforge.net
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef _EVENT_TIMELINE_H
+#define _EVENT_TIMELINE_H
+
+#include <QtCore/QVector>
+
+#include "atomic_int.h"
+#include "lmms_basics.h"
+
+class note;
+class trackContentObject;
+
+
+/*! \brief Everything a track has to start while playing the song, ordered
+ *  by position
+ *
+ * Compiled from the TCOs of a track by track::compileTimeline() on the
+ * editing thread whenever the track has been invalidated, so while playing
+ * a track only has to look at the events of the current position instead
+ * of going through all of its TCOs and their content again.
+ */
+class EventTimeline
+{
+public:
+	struct Event
+	{
+		tick_t pos;
+		trackContentObject * tco;
+		// note to start or NULL for start of TCO itself - might have
+		// been removed from TCO since compiling, so tracks have to
+		// check it's still there before using it
+		note * n;
+		// where n was in TCO when compiling, -1 if unused
+		int index;
+	} ;
+
+	typedef QVector<Event> EventVector;
+
+	// timelines with higher version were compiled later
+	EventTimeline( int _version = 0 );
+
+	int version() const
+	{
+		return m_version;
+	}
+
+	// for compiling
+	void addEvent( tick_t _pos, trackContentObject * _tco,
+				note * _note = NULL, int _index = -1 );
+	void finalize();
+
+	const EventVector & events() const
+	{
+		return m_events;
+	}
+
+	// index of first event at or after _pos - cheap when called for
+	// increasing positions as while playing, binary search otherwise
+	int firstEventFrom( tick_t _pos ) const;
+
+
+private:
+	EventVector m_events;
+	int m_version;
+	// where last call of firstEventFrom() ended up
+	mutable int m_cursor;
+
+} ;
+
+
+
+/*! \brief Timeline currently played by a track
+ *
+ * Shared by the track and the commands replacing its timeline at period
+ * boundaries, so a command still queued when the track is destroyed
+ * doesn't access freed memory.
+ */
+class EventTimelineSlot
+{
+public:
+	EventTimelineSlot();
+
+	void ref()
+	{
+		m_refs.fetchAndAddOrdered( 1 );
+	}
+
+	// deletes slot when last reference is dropped
+	void deref();
+
+	const EventTimeline & timeline() const
+	{
+		return *m_timeline;
+	}
+
+	// play _timeline from now on if it's newer than the current one -
+	// must only be called by render thread or while mixer is locked;
+	// returns the timeline which isn't used anymore
+	EventTimeline * replace( EventTimeline * _timeline );
+
+
+private:
+	~EventTimelineSlot();
+
+	EventTimeline * m_timeline;
+	AtomicInt m_refs;
+
+} ;
+
+
+#endif
@@ -31,6 +31,7 @@
 #include "JournallingObject.h"
 
 
+// default number of FX channels, not counting master channel
 const int NumFxChannels = 64;
 
 
@@ -39,6 +40,8 @@ struct FxChannel
 	FxChannel( Model * _parent );
 	~FxChannel();
 
+	void setName( const QString & _name );
+
 	EffectChain m_fxChain;
 	bool m_used;
 	bool m_stillRunning;
@@ -48,7 +51,23 @@ struct FxChannel
 	BoolModel m_muteModel;
 	FloatModel m_volumeModel;
 	QString m_name;
-	QMutex m_lock;
+	// copy of name in render tracer
+	int m_traceName;
+	// audio ports routed to this channel in current period, linked via
+	// AudioPort::m_nextFxInput in order of Mixer::m_audioPorts
+	AudioPort * m_firstInput;
+	AudioPort * m_lastInput;
+	// whether channel is in FxMixer::activeChannels()
+	bool m_active;
+	// index of job processing this channel in render-graph of current
+	// period
+	int m_renderJob;
+	// time (in microseconds) processing this channel took in previous
+	// period
+	int m_renderCost;
+	// time spent processing this channel and everything routed to it
+	ProfilerNode m_profile;
+	ProfilerNode m_inputProfile;
 
 } ;
 
@@ -60,10 +79,20 @@ public:
 	FxMixer();
 	virtual ~FxMixer();
 
+	// must only be called by the job processing channel _ch or while no
+	// jobs are running
 	void mixToChannel( const sampleFrame * _buf, fx_ch_t _ch );
+
+	// append _port to inputs of channel _ch - called when building the
+	// render-graph
+	void addInput( fx_ch_t _ch, AudioPort * _port );
+	// sum output of all input ports in the order they were added, so the
+	// result doesn't depend on the order jobs were finished in
+	void mixInputs( fx_ch_t _ch );
+
 	void processChannel( fx_ch_t _ch, sampleFrame * _buf = NULL );
 
-	void prepareMasterMix();
+	// mix all channels into _buf which has to be cleared before
 	void masterMix( sampleFrame * _buf );
 
 
@@ -79,16 +108,35 @@ public:
 
 	FxChannel * effectChannel( int _ch )
 	{
-		if( _ch >= 0 && _ch <= NumFxChannels )
+		if( _ch >= 0 && _ch <= numChannels() )
 		{
 			return m_fxChannels[_ch];
 		}
 		return NULL;
 	}
 
+	// number of FX channels, not counting master channel
+	inline int numChannels() const
+	{
+		return m_fxChannels.size() - 1;
+	}
+
+	// make channel _ch (except master) part of active channels, e.g.
+	// because an audio port is routed to it
+	void activateChannel( fx_ch_t _ch );
+
+	// channels which may receive input in current period or which
+	// still have effects running - all others are silent and don't need
+	// to be processed at all
+	inline const QVector<fx_ch_t> & activeChannels() const
+	{
+		return m_activeChannels;
+	}
+
 
 private:
-	FxChannel * m_fxChannels[NumFxChannels+1];	// +1 = master
+	QVector<FxChannel *> m_fxChannels;	// [0] = master
+	QVector<fx_ch_t> m_activeChannels;
 
 
 	friend class MixerWorkerThread;
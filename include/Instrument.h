@@ -133,6 +133,9 @@ protected:
 private:
 	InstrumentTrack * m_instrumentTrack;
 
+
+	friend class InstrumentPlayHandle;
+
 } ;
 
 #endif
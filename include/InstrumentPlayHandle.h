@@ -27,6 +27,7 @@
 
 #include "play_handle.h"
 #include "Instrument.h"
+#include "InstrumentTrack.h"
 
 
 class InstrumentPlayHandle : public playHandle
@@ -58,6 +59,11 @@ public:
 		return m_instrument->isFromTrack( _track );
 	}
 
+	virtual AudioPort * audioPort()
+	{
+		return m_instrument->instrumentTrack()->audioPort();
+	}
+
 
 private:
 	Instrument * m_instrument;
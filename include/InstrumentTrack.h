@@ -45,6 +45,7 @@ class InstrumentFunctionNoteStackingView;
 class EffectRackView;
 class InstrumentSoundShapingView;
 class fadeButton;
+class bbTrack;
 class Instrument;
 class InstrumentTrackWindow;
 class InstrumentMidiIOView;
@@ -53,6 +54,7 @@ class lcdSpinBox;
 class midiPortMenu;
 class multimediaProject;
 class notePlayHandle;
+class pattern;
 class PluginView;
 class tabWidget;
 class trackLabelButton;
@@ -121,8 +123,8 @@ public:
 		return m_pitchRangeModel.value();
 	}
 
-	// play everything in given frame-range - creates note-play-handles
-	virtual bool play( const MidiTime & _start, const fpp_t _frames,
+	// play everything in given range - creates note-play-handles
+	virtual bool play( const MidiTime & _start, const MidiTime & _end,
 						const f_cnt_t _frame_base, int _tco_num = -1 );
 	// create new view for me
 	virtual trackView * createView( TrackContainerView* tcv );
@@ -215,6 +217,8 @@ protected:
 		return "instrumenttrack";
 	}
 
+	virtual void compileTimeline( EventTimeline & _timeline );
+
 
 protected slots:
 	void updateBaseNote();
@@ -223,6 +227,12 @@ protected slots:
 
 
 private:
+	// start playing frozen pattern or note number _note_idx of it
+	void playFrozenPattern( pattern * _p, bbTrack * _bb_track,
+						const f_cnt_t _offset );
+	bool startNote( pattern * _p, int _note_idx, bbTrack * _bb_track,
+				const f_cnt_t _offset, const bool _in_song );
+
 	AudioPort m_audioPort;
 	MidiPort m_midiPort;
 
@@ -233,6 +243,10 @@ private:
 	IntModel m_baseNoteModel;
 
 	NotePlayHandleList m_processHandles;
+	// top-level note-play-handles of this track which are rendered by the
+	// mixer, in the order they were added - only changed while mixer is
+	// locked, so it can be read while rendering
+	NotePlayHandleList m_voices;
 
 	FloatModel m_volumeModel;
 	FloatModel m_panningModel;
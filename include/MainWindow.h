@@ -113,6 +113,7 @@ public slots:
 	void toggleFxMixerWin( void );
 	void togglePianoRollWin( void );
 	void toggleControllerRack( void );
+	void toggleRenderTrace( bool _on );
 
 	void undo( void );
 	void redo( void );
@@ -0,0 +1,43 @@
+/*
+ * MemoryHelper.h - helper functions for allocating aligned memory
+ *
+ * Copyright (c) 2014 Tobias Doerffel <tobydox/at/users.sourceforge.net>
+ *
+ * This file is part of Linux MultiMedia Studio - http://lmms.sourceforge.net
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef _MEMORY_HELPER_H
+#define _MEMORY_HELPER_H
+
+#include "export.h"
+
+
+class EXPORT MemoryHelper
+{
+public:
+	/*! \brief Allocate _bytes bytes aligned to ALIGN_SIZE */
+	static void * alignedMalloc( int _bytes );
+
+	/*! \brief Free memory allocated by alignedMalloc() */
+	static void alignedFree( void * _buf );
+
+} ;
+
+
+#endif
@@ -0,0 +1,135 @@
+/*
+ * MemoryPool.h - fixed-capacity lock-free pool for objects allocated while
+ *                rendering
+ *
+ * Copyright (c) 2014 Tobias Doerffel <tobydox/at/users.sourceforge.net>
+ *
+ * This file is part of Linux MultiMedia Studio - http://lmms.sourceforge.net
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef _MEMORY_POOL_H
+#define _MEMORY_POOL_H
+
+#include <cstddef>
+
+#include <QtCore/QVector>
+
+#include "atomic_int.h"
+#include "export.h"
+
+
+/*! \brief Preallocated slots of fixed size for objects which are created and
+ *         destroyed at note rate
+ *
+ * Slots are handed out and taken back without locking and without calling
+ * into the system allocator, so it's safe to do so from the render threads.
+ * If all slots are in use (or an object is bigger than a slot) the pool
+ * falls back to the heap and counts it as overflow.
+ */
+class EXPORT MemoryPool
+{
+public:
+	struct Statistics
+	{
+		const char * name;
+		int capacity;
+		int used;
+		int peak;
+		int overflows;
+	} ;
+
+	typedef QVector<Statistics> StatisticsList;
+
+	MemoryPool( const char * _name, size_t _objectSize, int _capacity );
+	~MemoryPool();
+
+	void * allocate( size_t _size );
+	void deallocate( void * _ptr );
+
+	Statistics statistics() const;
+
+	// statistics of all pools created so far
+	static StatisticsList allStatistics();
+
+
+private:
+	enum
+	{
+		IndexBits = 16,
+		IndexMask = ( 1 << IndexBits ) - 1,
+		NilIndex = IndexMask,
+		MaxCapacity = NilIndex - 1
+	} ;
+
+	int pop();
+	void push( int _index );
+	static int nextTag( int _head );
+
+	const char * m_name;
+	size_t m_slotSize;
+	int m_capacity;
+	char * m_memory;
+	int * m_next;
+
+	// head of free list - lower bits hold index of first free slot,
+	// upper bits a tag incremented on every change (avoids ABA problem)
+	AtomicInt m_head;
+
+	AtomicInt m_used;
+	AtomicInt m_peak;
+	AtomicInt m_overflows;
+
+} ;
+
+
+
+/*! \brief Route operator new/delete of a class through a MemoryPool
+ *
+ * MM_POOLED_ALLOCATION has to be put into the public section of the class
+ * declaration and MM_POOL_DEFINITION into the implementation file. The pool
+ * lives until the program exits so that objects deleted during shutdown can
+ * still be returned to it.
+ *
+ * The pool is created by the first call of pool(), which allocates and
+ * locks, so this has to happen before render threads create objects -
+ * engine::initMemoryPools() does so for the classes of the core, plugins
+ * call pool() when their instrument is created.
+ */
+#define MM_POOLED_ALLOCATION( _class )					\
+	static MemoryPool & pool();					\
+	static void * operator new( size_t _size )			\
+	{								\
+		return pool().allocate( _size );			\
+	}								\
+	static void operator delete( void * _ptr )			\
+	{								\
+		pool().deallocate( _ptr );				\
+	}
+
+#define MM_POOL_DEFINITION( _class, _capacity )				\
+	MemoryPool & _class::pool()					\
+	{								\
+		static MemoryPool * s_pool =				\
+			new MemoryPool( #_class, sizeof( _class ),	\
+							_capacity );	\
+		return *s_pool;						\
+	}
+
+
+#endif
@@ -47,6 +47,30 @@ void multiplyAndAddMultiplied( sampleFrame* dst, const sampleFrame* src, float c
 /*! \brief Multiply dst by coeffDst and add samples from srcLeft/srcRight multiplied by coeffSrc */
 void multiplyAndAddMultipliedJoined( sampleFrame* dst, const sample_t* srcLeft, const sample_t* srcRight, float coeffDst, float coeffSrc, int frames );
 
+/*! \brief Multiply samples in dst by coeff */
+void multiply( sampleFrame* dst, float coeff, int frames );
+
+/*! \brief Multiply each frame in dst by corresponding value in coeffs */
+void multiplyByBuffer( sampleFrame* dst, const float* coeffs, int frames );
+
+/*! \brief Add samples from src multiplied by corresponding value in coeffsSrc to dst */
+void addMultipliedByBuffer( sampleFrame* dst, const sampleFrame* src, const float* coeffsSrc, int frames );
+
+/*! \brief Determine maximum absolute value of left and right channel of src */
+void peakValues( const sampleFrame* src, int frames, float* peakLeft, float* peakRight );
+
+/*! \brief Clip samples from src multiplied by gain to [-1;1] and convert them to 16 bit integers (scaled by OUTPUT_SAMPLE_MULTIPLIER) */
+void convertToS16( const sample_t* src, int samples, float gain, int_sample_t* dst );
+
+/*! \brief Split interleaved frames from src into separate left and right channel buffers */
+void deinterleave( const sampleFrame* src, int frames, sample_t* left, sample_t* right );
+
+/*! \brief Merge separate left and right channel buffers into interleaved frames in dst */
+void interleave( const sample_t* left, const sample_t* right, int frames, sampleFrame* dst );
+
+/*! \brief Name of instruction set used by the functions above - chosen at runtime depending on the CPU */
+const char* instructionSet();
+
 }
 
 #endif
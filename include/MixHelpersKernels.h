@@ -0,0 +1,65 @@
+/*
+ * MixHelpersKernels.h - implementations of mixing functions for different
+ *                       instruction sets
+ *
+ * Copyright (c) 2014 Tobias Doerffel <tobydox/at/users.sourceforge.net>
+ *
+ * This file is part of Linux MultiMedia Studio - http://lmms.sourceforge.net
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef _MIX_HELPERS_KERNELS_H
+#define _MIX_HELPERS_KERNELS_H
+
+#include "lmmsconfig.h"
+#include "lmms_basics.h"
+
+namespace MixHelpers
+{
+
+/*! \brief Table of kernels for one instruction set
+ *
+ * All kernels work on interleaved stereo samples, so "samples" always is
+ * twice the number of frames. deinterleave() and interleave() convert
+ * between interleaved and planar buffers of "frames" frames.
+ */
+struct Kernels
+{
+	const char* name;
+	void (*add)( sample_t* dst, const sample_t* src, int samples );
+	void (*addMultiplied)( sample_t* dst, const sample_t* src, float coeff, int samples );
+	void (*addMultipliedStereo)( sample_t* dst, const sample_t* src, float coeffLeft, float coeffRight, int samples );
+	void (*multiplyAndAddMultiplied)( sample_t* dst, const sample_t* src, float coeffDst, float coeffSrc, int samples );
+	void (*multiply)( sample_t* dst, float coeff, int samples );
+	void (*peakValues)( const sample_t* src, int samples, float* peakLeft, float* peakRight );
+	void (*convertToS16)( const sample_t* src, int samples, float gain, int_sample_t* dst );
+	void (*deinterleave)( const sample_t* src, int frames, sample_t* left, sample_t* right );
+	void (*interleave)( const sample_t* left, const sample_t* right, int frames, sample_t* dst );
+} ;
+
+extern const Kernels genericKernels;
+
+#if defined(LMMS_HOST_X86) || defined(LMMS_HOST_X86_64)
+// compiled with -msse2 / -mavx, so only use them if CPU supports it
+extern const Kernels sse2Kernels;
+extern const Kernels avxKernels;
+#endif
+
+}
+
+#endif
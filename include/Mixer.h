@@ -41,21 +41,28 @@
 #include <QtCore/QMutex>
 #include <QtCore/QThread>
 #include <QtCore/QVector>
-#include <QtCore/QWaitCondition>
 
 
 #include "lmms_basics.h"
 #include "note.h"
 #include "fifo_buffer.h"
+#include "RenderProfiler.h"
+#include "RealtimeCommandQueue.h"
+#include "RenderTracer.h"
 
 
 class AudioDevice;
 class MidiClient;
 class AudioPort;
+class SampleBuffer;
 
 
 const fpp_t DEFAULT_BUFFER_SIZE = 256;
 
+// number of periods buffered at most with adaptive latency unless
+// configured otherwise
+const int DefaultMaxFifoDepth = 8;
+
 const int BYTES_PER_SAMPLE = sizeof( sample_t );
 const int BYTES_PER_INT_SAMPLE = sizeof( int_sample_t );
 const int BYTES_PER_FRAME = sizeof( sampleFrame );
@@ -217,22 +224,14 @@ public:
 	}
 
 
-	// play-handle stuff
-	inline bool addPlayHandle( playHandle * _ph )
-	{
-		if( criticalXRuns() == false )
-		{
-			lock();
-			m_playHandles.push_back( _ph );
-			unlock();
-			return true;
-		}
-		delete _ph;
-		return false;
-	}
+	// play-handle stuff - new play-handles are queued without locking and
+	// get rendered from next period on
+	bool addPlayHandle( playHandle * _ph );
 
 	void removePlayHandle( playHandle * _ph );
 
+	// play-handles being rendered - lock mixer before accessing them
+	// from another thread
 	inline PlayHandleList & playHandles()
 	{
 		return m_playHandles;
@@ -260,6 +259,51 @@ public:
 		return m_cpuLoad;
 	}
 
+	// number of periods buffered between rendering and audio device -
+	// changes at runtime if adaptive latency is enabled
+	inline int fifoDepth() const
+	{
+		return m_fifo->limit();
+	}
+
+	// number of threads processing jobs, including the one which
+	// calls renderNextBuffer()
+	inline int numWorkers() const
+	{
+		return m_numWorkers+1;
+	}
+
+	inline const MixerWorkerThread * worker( int _worker ) const
+	{
+		return m_workers[_worker];
+	}
+
+	inline const RenderProfiler & profiler() const
+	{
+		return m_profiler;
+	}
+
+	// changes of render state posted here are applied at start of next
+	// period instead of locking the mixer
+	inline RealtimeCommandQueue & commandQueue()
+	{
+		return m_commandQueue;
+	}
+
+	// start recording timeline of render threads
+	void startTracing();
+	void stopTracing();
+
+	inline const RenderTracer & tracer() const
+	{
+		return m_tracer;
+	}
+
+	inline RenderTracer & tracer()
+	{
+		return m_tracer;
+	}
+
 	const qualitySettings & currentQualitySettings() const
 	{
 		return m_qualitySettings;
@@ -301,10 +345,19 @@ public:
 	void lock()
 	{
 		m_globalMutex.lock();
+		if( m_lockDepth++ == 0 )
+		{
+			m_commandQueue.setLockingThread(
+						QThread::currentThread() );
+		}
 	}
 
 	void unlock()
 	{
+		if( --m_lockDepth == 0 )
+		{
+			m_commandQueue.setLockingThread( NULL );
+		}
 		m_globalMutex.unlock();
 	}
 
@@ -357,10 +410,7 @@ public:
 		return m_inputBufferFrames[ m_inputBufferRead ];
 	}
 
-	inline const surroundSampleFrame * nextBuffer()
-	{
-		return hasFifoWriter() ? m_fifo->read() : renderNextBuffer();
-	}
+	const surroundSampleFrame * nextBuffer();
 
 	void changeQuality( const struct qualitySettings & _qs );
 
@@ -398,6 +448,11 @@ private:
 	void startProcessing( bool _needs_fifo = true );
 	void stopProcessing();
 
+	// metronome is triggered by render thread, so load sample and create
+	// audio port in advance
+	void createMetronome();
+	void destroyMetronome();
+
 
 	AudioDevice * tryAudioDevices();
 	MidiClient * tryMidiClients();
@@ -405,6 +460,27 @@ private:
 
 	const surroundSampleFrame * renderNextBuffer();
 
+	// fill job queue with all jobs of current period and the
+	// dependencies between them
+	void buildRenderGraph();
+
+	// publish time spent rendering each node in current period
+	void finishProfilingPeriod();
+
+	// called by fifo writer after each period if adaptive latency is
+	// enabled - grows fifo depth if audio device had to wait for a
+	// period or rendering came close to the deadline and shrinks it
+	// again after having been stable for a while
+	void adaptFifoDepth( int _renderTime );
+
+	// push _ph onto one of the lock-free stacks of play-handles
+	static void pushPlayHandle( AtomicPointer<playHandle> & _stack,
+							playHandle * _ph );
+	// add queued play-handles and remove the ones requested to be
+	// removed - mixer has to be locked
+	void processQueuedPlayHandles();
+	void requestRemoval( playHandle * _ph );
+
 
 
 	QVector<AudioPort *> m_audioPorts;
@@ -436,11 +512,18 @@ private:
 	int m_cpuLoad;
 	QVector<MixerWorkerThread *> m_workers;
 	int m_numWorkers;
-	QWaitCondition m_queueReadyWaitCond;
+
+	RenderProfiler m_profiler;
+	RenderTracer m_tracer;
+
+	RealtimeCommandQueue m_commandQueue;
 
 
 	PlayHandleList m_playHandles;
-	ConstPlayHandleList m_playHandlesToRemove;
+	// lock-free stacks of play-handles to add or remove, linked via
+	// playHandle::m_nextQueued
+	AtomicPointer<playHandle> m_newPlayHandles;
+	AtomicPointer<playHandle> m_playHandlesToRemove;
 
 	struct qualitySettings m_qualitySettings;
 	float m_masterGain;
@@ -456,11 +539,28 @@ private:
 
 
 	QMutex m_globalMutex;
+	// how often m_globalMutex is locked recursively by its owner
+	int m_lockDepth;
 	QMutex m_inputFramesMutex;
 
 
 	fifo * m_fifo;
 	fifoWriter * m_fifoWriter;
+	// buffers passed through m_fifo - used in turn, there's one for each
+	// slot of the fifo plus one being written and one being read
+	QVector<surroundSampleFrame *> m_fifoBuffers;
+	int m_nextFifoBuffer;
+
+	bool m_adaptiveLatency;
+	int m_minFifoDepth;
+	int m_maxFifoDepth;
+	// number of times audio device found fifo empty
+	AtomicInt m_fifoUnderruns;
+	bool m_fifoPrimed;
+	int m_stablePeriods;
+
+	SampleBuffer * m_metronomeSample;
+	AudioPort * m_metronomePort;
 
 
 	friend class engine;
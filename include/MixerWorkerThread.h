@@ -0,0 +1,263 @@
+/*
+ * MixerWorkerThread.h - declaration of class MixerWorkerThread
+ *
+ * Copyright (c) 2014 Tobias Doerffel <tobydox/at/users.sourceforge.net>
+ *
+ * This file is part of Linux MultiMedia Studio - http://lmms.sourceforge.net
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef _MIXER_WORKER_THREAD_H
+#define _MIXER_WORKER_THREAD_H
+
+#include <QtCore/QThread>
+#include <QtCore/QVector>
+
+#include "atomic_int.h"
+#include "EventCount.h"
+#include "Mixer.h"
+
+
+// define a pause instruction for spinlock-loop - merely useful on
+// HyperThreading systems with just one physical core (e.g. Intel Atom)
+#ifdef LMMS_HOST_X86
+#define SPINLOCK_PAUSE()        asm( "pause" )
+#else
+#ifdef LMMS_HOST_X86_64
+#define SPINLOCK_PAUSE()        asm( "pause" )
+#else
+#define SPINLOCK_PAUSE()
+#endif
+#endif
+
+
+class MixerWorkerThread : public QThread
+{
+public:
+	enum JobTypes
+	{
+		InvalidJob,
+		PlayHandle,
+		AudioPortEffects,
+		EffectChannel,
+		NumJobTypes
+	} ;
+
+	enum Successors
+	{
+		NoSuccessor = -1,	// nothing depends on this job
+		AllAudioPorts = -2	// all audio-port-jobs depend on this job
+	} ;
+
+	// one node of the render-graph of the current period - a job becomes
+	// ready as soon as all jobs it depends on have been finished
+	struct JobQueueItem
+	{
+		JobTypes type;
+		void * job;
+		int param;
+		int successor;
+
+		// time (in microseconds) job took in previous period
+		int cost;
+
+		// number of unfinished jobs this job depends on
+		AtomicInt pending;
+	} ;
+
+
+	// double-ended queue of ready jobs owned by one worker - the owner
+	// pushes and pops jobs at the bottom while other workers steal jobs
+	// from the top if they run out of work
+	class WorkerQueue
+	{
+	public:
+		WorkerQueue();
+
+		// make room for _capacity jobs and remove all jobs - must not be
+		// called while jobs are processed
+		void reset( int _capacity );
+
+		// called by owner only
+		void push( int _item );
+		int pop();
+
+		// called by any other worker
+		int steal();
+
+
+	private:
+		// keep the indices of different workers in different
+		// cache lines
+		char m_pad0[64];
+		AtomicInt m_top;
+		char m_pad1[64-sizeof(AtomicInt)];
+		AtomicInt m_bottom;
+		char m_pad2[64-sizeof(AtomicInt)];
+		QVector<int> m_items;
+
+	} ;
+
+
+	class JobQueue
+	{
+	public:
+		JobQueue();
+		~JobQueue();
+
+		// create one WorkerQueue for each thread processing jobs
+		void setWorkerCount( int _workers );
+
+		// remove all jobs - waits for workers still leaving
+		// previous period
+		void reset();
+
+		int addJob( JobTypes _type, void * _job, int _param = 0,
+				int _successor = NoSuccessor, int _cost = 0 );
+
+		// increase number of jobs given job depends on
+		void addDependency( int _item );
+
+		// mark the range of jobs which AllAudioPorts refers to
+		void setAudioPortJobs( int _first, int _count )
+		{
+			m_firstAudioPortJob = _first;
+			m_numAudioPortJobs = _count;
+		}
+
+		// distribute all jobs without dependencies, most expensive
+		// ones first, to the workers and wake them up
+		void start();
+
+		// number of periods started so far
+		inline int epoch() const
+		{
+			return m_epoch;
+		}
+
+		// notified whenever a period is started, a job became ready or
+		// all jobs have been finished
+		inline EventCount & wakeUp()
+		{
+			return m_wakeUp;
+		}
+
+		// register worker for processing jobs of current period,
+		// returns false if there's no period running
+		bool enter();
+		void leave();
+
+		inline int size() const
+		{
+			return m_queueSize;
+		}
+
+		inline const JobQueueItem & item( int _item ) const
+		{
+			return m_items[_item];
+		}
+
+		inline bool isDone() const
+		{
+			return m_started == 0 || m_itemsDone >= m_queueSize;
+		}
+
+		// fetch next job which is ready for being processed from
+		// worker's own queue or steal one from other workers,
+		// returns -1 if there's none at the moment
+		int takeReadyItem( int _worker );
+
+		// mark job as finished and release all jobs depending on it
+		// into worker's own queue
+		void finishJob( int _item, int _worker );
+
+
+	private:
+		bool release( int _item, int _worker );
+
+		QVector<JobQueueItem> m_items;
+		volatile int m_queueSize;
+		AtomicInt m_itemsDone;
+		AtomicInt m_started;
+		AtomicInt m_epoch;
+		AtomicInt m_activeWorkers;
+		EventCount m_wakeUp;
+
+		int m_firstAudioPortJob;
+		int m_numAudioPortJobs;
+
+		QVector<WorkerQueue *> m_workerQueues;
+		QVector<int> m_readyItems;
+
+	} ;
+
+
+	// how long a worker spent doing what - all times in microseconds
+	struct Statistics
+	{
+		Statistics() :
+			workTime( 0 ),
+			spinTime( 0 ),
+			sleepTime( 0 ),
+			sleeps( 0 )
+		{
+		}
+
+		qint64 workTime;
+		qint64 spinTime;
+		qint64 sleepTime;
+		int sleeps;
+	} ;
+
+
+	static JobQueue s_jobQueue;
+
+	MixerWorkerThread( int _worker_num, Mixer* mixer );
+	virtual ~MixerWorkerThread();
+
+	virtual void quit();
+
+	// process jobs until all jobs of current render-graph are finished
+	void processJobQueue();
+
+	const Statistics & statistics() const
+	{
+		return m_statistics;
+	}
+
+
+private:
+	virtual void run();
+
+	// process job and remember how long it took
+	void processJob( const JobQueueItem & _it );
+
+	// spin for a while and then sleep until _cond() returns true
+	template<class CONDITION>
+	void waitFor( CONDITION & _cond, RenderTracer::EventTypes _traceType );
+
+	sampleFrame * m_workingBuf;
+	int m_workerNum;
+	volatile bool m_quit;
+	Mixer* m_mixer;
+	Statistics m_statistics;
+
+} ;
+
+
+#endif
@@ -34,6 +34,7 @@
 #endif
 
 #include "SampleBuffer.h"
+#include "MemoryPool.h"
 #include "lmms_constants.h"
 
 
@@ -80,6 +81,9 @@ public:
 		delete m_subOsc;
 	}
 
+	// instruments create several oscillators per note
+	MM_POOLED_ALLOCATION( Oscillator )
+
 
 	inline void setUserWave( const SampleBuffer * _wave )
 	{
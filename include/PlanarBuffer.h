@@ -0,0 +1,94 @@
+/*
+ * PlanarBuffer.h - audio buffer holding each channel in a separate block
+ *
+ * Copyright (c) 2014 Tobias Doerffel <tobydox/at/users.sourceforge.net>
+ *
+ * This file is part of Linux MultiMedia Studio - http://lmms.sourceforge.net
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef _PLANAR_BUFFER_H
+#define _PLANAR_BUFFER_H
+
+#include "lmms_basics.h"
+#include "export.h"
+
+
+/*! \brief Deinterleaved audio buffer
+ *
+ * Samples of each channel are stored contiguously and every channel starts
+ * at a 32 byte boundary, so DSP code can process whole AVX registers
+ * without shuffling. fromInterleaved() and toInterleaved() convert from/to
+ * the sampleFrame buffers used by the rest of the engine.
+ */
+class EXPORT PlanarBuffer
+{
+public:
+	enum
+	{
+		Alignment = 32
+	} ;
+
+	PlanarBuffer( ch_cnt_t _channels, fpp_t _frames );
+	~PlanarBuffer();
+
+	inline ch_cnt_t channels() const
+	{
+		return m_channels;
+	}
+
+	inline fpp_t frames() const
+	{
+		return m_frames;
+	}
+
+	inline sample_t * channel( ch_cnt_t _ch )
+	{
+		return m_data + _ch * m_stride;
+	}
+
+	inline const sample_t * channel( ch_cnt_t _ch ) const
+	{
+		return m_data + _ch * m_stride;
+	}
+
+	// make room for at least _frames frames - contents are lost if
+	// buffer has to grow
+	void resize( fpp_t _frames );
+
+	void clear();
+
+	// copy first DEFAULT_CHANNELS channels from/to interleaved buffer
+	void fromInterleaved( const sampleFrame * _src, fpp_t _frames );
+	void toInterleaved( sampleFrame * _dst, fpp_t _frames ) const;
+
+
+private:
+	void allocate();
+
+	ch_cnt_t m_channels;
+	fpp_t m_frames;
+	// distance between channels in samples
+	int m_stride;
+	void * m_memory;
+	sample_t * m_data;
+
+} ;
+
+
+#endif
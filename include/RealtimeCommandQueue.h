@@ -0,0 +1,141 @@
+/*
+ * RealtimeCommandQueue.h - changes of render state applied by render thread
+ *
+ * Copyright (c) 2014 Tobias Doerffel <tobydox/at/users.sourceforge.net>
+ *
+ * This file is part of Linux MultiMedia Studio - http://lmms.sourceforge.net
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef _REALTIME_COMMAND_QUEUE_H
+#define _REALTIME_COMMAND_QUEUE_H
+
+#include <QtCore/QMutex>
+
+#include "atomic_int.h"
+#include "EventCount.h"
+#include "export.h"
+
+class QThread;
+
+
+/*! \brief Change of state used while rendering
+ *
+ * Everything expensive (allocating, building tables etc.) is done when
+ * creating the command, execute() then only swaps the prepared data in.
+ */
+class EXPORT RealtimeCommand
+{
+public:
+	RealtimeCommand() :
+		m_next( NULL ),
+		m_waitedFor( false ),
+		m_executed( false )
+	{
+	}
+
+	virtual ~RealtimeCommand()
+	{
+	}
+
+	// called by render thread at start of a period - must neither block
+	// nor allocate or free memory
+	virtual void execute() = 0;
+
+	// called by a non-realtime thread after execute() - whatever the
+	// command swapped out can be freed here or in the destructor
+	virtual void finish()
+	{
+	}
+
+
+private:
+	RealtimeCommand * m_next;
+	bool m_waitedFor;
+	volatile bool m_executed;
+
+	friend class RealtimeCommandQueue;
+
+} ;
+
+
+
+/*! \brief Lock-free queue of commands executed at period boundaries
+ *
+ * Instead of locking the mixer (and thereby stalling rendering) while
+ * changing state used by the render threads, other threads post commands
+ * which are executed before the next period is rendered. Executed commands
+ * are finished and deleted by the posting threads, so the render thread
+ * never frees memory. While the mixer isn't processing, commands are
+ * executed right away by the posting thread.
+ */
+class EXPORT RealtimeCommandQueue
+{
+public:
+	RealtimeCommandQueue();
+	~RealtimeCommandQueue();
+
+	// queue _cmd and take ownership of it
+	void post( RealtimeCommand * _cmd );
+
+	// queue _cmd and return after it has been executed and finished
+	void postAndWait( RealtimeCommand * _cmd );
+
+	// return after all commands posted so far have been executed
+	void sync();
+
+	// execute all queued commands - called by render thread
+	void process();
+
+	// set by mixer when starting and stopping processing - when
+	// deactivated, commands still queued are executed
+	void setActive( bool _active );
+
+	// finish and delete executed commands
+	void collectGarbage();
+
+	// set by mixer when a thread locks or unlocks it - the render thread
+	// can't process commands meanwhile, so postAndWait() called by that
+	// thread processes them itself instead of waiting forever
+	void setLockingThread( QThread * _thread )
+	{
+		m_lockingThread = _thread;
+	}
+
+
+private:
+	static void push( AtomicPointer<RealtimeCommand> & _stack,
+						RealtimeCommand * _cmd );
+	void executeDirectly( RealtimeCommand * _cmd );
+
+	// lock-free stacks linked via RealtimeCommand::m_next
+	AtomicPointer<RealtimeCommand> m_pending;
+	AtomicPointer<RealtimeCommand> m_executed;
+
+	EventCount m_executedEvent;
+	volatile bool m_active;
+	QThread * volatile m_processingThread;
+	QThread * volatile m_lockingThread;
+
+	// serializes executing commands while not active
+	QMutex m_mutex;
+
+} ;
+
+
+#endif
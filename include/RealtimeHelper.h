@@ -0,0 +1,100 @@
+/*
+ * RealtimeHelper.h - CPU affinity, scheduling and memory locking for
+ *                    threads taking part in rendering
+ *
+ * Copyright (c) 2014 Tobias Doerffel <tobydox/at/users.sourceforge.net>
+ *
+ * This file is part of Linux MultiMedia Studio - http://lmms.sourceforge.net
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef _REALTIME_HELPER_H
+#define _REALTIME_HELPER_H
+
+#include <QtCore/QList>
+#include <QtCore/QString>
+
+#include "export.h"
+
+
+class EXPORT RealtimeHelper
+{
+public:
+	enum SchedulingPolicies
+	{
+		Policy_Default,
+		Policy_Fifo,
+		Policy_RoundRobin,
+		Policy_Invalid
+	} ;
+
+	struct Settings
+	{
+		Settings() :
+			cpus(),
+			policy( Policy_Default ),
+			priority( 0 ),
+			lockMemory( false )
+		{
+		}
+
+		// CPUs render threads are pinned to - empty for no pinning
+		QList<int> cpus;
+		SchedulingPolicies policy;
+		// 0 picks a priority in the middle of the allowed range
+		int priority;
+		bool lockMemory;
+	} ;
+
+	/*! \brief Read settings from section "realtime" of config file */
+	static void loadSettings();
+
+	/*! \brief Settings used for render threads, may be altered by
+	 * command line options before engine is initialized */
+	static Settings & settings()
+	{
+		return s_settings;
+	}
+
+	/*! \brief Parse a list like "0,2-3" into CPU numbers, returns
+	 * false if _list is malformed */
+	static bool parseCpuList( const QString & _list, QList<int> * _cpus );
+
+	/*! \brief Parse "default", "fifo" or "rr" */
+	static SchedulingPolicies parsePolicy( const QString & _policy );
+
+	/*! \brief Apply configured CPU affinity and scheduling policy to
+	 * calling thread - _index selects the CPU out of configured list */
+	static void setupThread( int _index );
+
+	/*! \brief Lock all memory of process if configured so that audio
+	 * threads never wait for pages being swapped in */
+	static void lockMemory();
+
+	/*! \brief Touch every page of given buffer so that first access
+	 * from an audio thread doesn't cause a page fault */
+	static void prefault( void * _buf, int _bytes );
+
+
+private:
+	static Settings s_settings;
+
+} ;
+
+
+#endif
@@ -0,0 +1,64 @@
+/*
+ * RealtimeLog.h - non-blocking logging for render threads
+ *
+ * Copyright (c) 2014 Tobias Doerffel <tobydox/at/users.sourceforge.net>
+ *
+ * This file is part of Linux MultiMedia Studio - http://lmms.sourceforge.net
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef _REALTIME_LOG_H
+#define _REALTIME_LOG_H
+
+#include <QtCore/QString>
+
+#include "export.h"
+
+
+/*! \brief Log for messages of render threads
+ *
+ * post() formats the message into a slot of a lock-free queue and returns
+ * without ever waiting for a lock or doing I/O - if the queue is full, the
+ * message is dropped and counted. A low priority thread writes queued
+ * messages to stderr or a file. Messages are counted per call site (i.e.
+ * per format string) and each site is limited to a few messages per
+ * second, so a plugin failing in every period doesn't flood the output.
+ */
+class EXPORT RealtimeLog
+{
+public:
+	/*! \brief Queue message - _format has to be a string literal as its
+	 * address identifies the call site */
+	static void post( const char * _format, ... )
+#ifdef __GNUC__
+		__attribute__(( format( printf, 1, 2 ) ))
+#endif
+		;
+
+	/*! \brief Start writing queued messages to _file (stderr if
+	 * empty) - messages posted before are printed immediately */
+	static void start( const QString & _file );
+
+	/*! \brief Write remaining messages and statistics of call sites
+	 * which were rate limited or dropped messages */
+	static void stop();
+
+} ;
+
+
+#endif
@@ -0,0 +1,63 @@
+/*
+ * RenderLoadMeter.h - widget showing share of a period spent rendering a
+ *                     track or FX channel
+ *
+ * Copyright (c) 2014 Tobias Doerffel <tobydox/at/users.sourceforge.net>
+ *
+ * This file is part of Linux MultiMedia Studio - http://lmms.sourceforge.net
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef _RENDER_LOAD_METER_H
+#define _RENDER_LOAD_METER_H
+
+#include <QtGui/QWidget>
+
+class ProfilerNode;
+
+
+class RenderLoadMeter : public QWidget
+{
+	Q_OBJECT
+public:
+	// shows sum of times of _node and _secondNode (if given)
+	RenderLoadMeter( QWidget * _parent, const ProfilerNode * _node,
+				const ProfilerNode * _secondNode = NULL );
+	virtual ~RenderLoadMeter();
+
+
+protected:
+	virtual void paintEvent( QPaintEvent * _pe );
+
+
+private slots:
+	void updateLoad();
+
+
+private:
+	const ProfilerNode * m_node;
+	const ProfilerNode * m_secondNode;
+
+	// percentage of period, falls off slowly after peaks
+	float m_load;
+	int m_lastPeriod;
+
+} ;
+
+
+#endif
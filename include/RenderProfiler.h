@@ -0,0 +1,121 @@
+/*
+ * RenderProfiler.h - measure time spent rendering tracks, effects,
+ *                    FX channels and stages of a period
+ *
+ * Copyright (c) 2014 Tobias Doerffel <tobydox/at/users.sourceforge.net>
+ *
+ * This file is part of Linux MultiMedia Studio - http://lmms.sourceforge.net
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef _RENDER_PROFILER_H
+#define _RENDER_PROFILER_H
+
+#include "atomic_int.h"
+#include "MicroTimer.h"
+#include "export.h"
+
+
+// time spent rendering a single node (track, effect, FX channel)
+class ProfilerNode
+{
+public:
+	ProfilerNode() :
+		m_current( 0 ),
+		m_time( 0 )
+	{
+	}
+
+	// add time (in microseconds) - may be called from several render
+	// threads at once
+	inline void add( int _usecs )
+	{
+		m_current.fetchAndAddOrdered( _usecs );
+	}
+
+	// publish time accumulated in current period - called by the
+	// thread rendering periods after all jobs have been finished
+	inline void finishPeriod()
+	{
+		m_time = m_current.fetchAndStoreOrdered( 0 );
+	}
+
+	// time (in microseconds) spent in last finished period
+	inline int time() const
+	{
+		return m_time;
+	}
+
+
+private:
+	AtomicInt m_current;
+	volatile int m_time;
+
+} ;
+
+
+
+
+class EXPORT RenderProfiler
+{
+public:
+	enum Stages
+	{
+		Stage_Song,		// song::processNextBuffer()
+		Stage_Graph,		// building render-graph
+		Stage_Jobs,		// processing all jobs
+		Stage_MasterMix,	// FxMixer::masterMix() etc.
+		Stage_Period,		// whole period
+		NumStages
+	} ;
+
+	struct Snapshot
+	{
+		// number of periods finished so far
+		int period;
+		// time (in microseconds) available for rendering a period
+		int periodLength;
+		// time (in microseconds) spent in each stage
+		int stageTime[NumStages];
+	} ;
+
+	RenderProfiler();
+
+	// called by the thread rendering periods
+	void startPeriod();
+	void finishStage( Stages _stage );
+	void finishPeriod( int _periodLength );
+
+	// consistent copy of data of last finished period, never blocks
+	// the render thread
+	Snapshot snapshot() const;
+
+
+private:
+	MicroTimer m_periodTimer;
+	MicroTimer m_stageTimer;
+	Snapshot m_current;
+
+	// odd while m_published is written
+	mutable AtomicInt m_sequence;
+	Snapshot m_published;
+
+} ;
+
+
+#endif
@@ -0,0 +1,135 @@
+/*
+ * RenderTracer.h - record timeline of render threads and write it as
+ *                  Chrome trace (JSON)
+ *
+ * Copyright (c) 2014 Tobias Doerffel <tobydox/at/users.sourceforge.net>
+ *
+ * This file is part of Linux MultiMedia Studio - http://lmms.sourceforge.net
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#ifndef _RENDER_TRACER_H
+#define _RENDER_TRACER_H
+
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+#include "lmmsconfig.h"
+
+#ifdef LMMS_HAVE_SYS_TIME_H
+#include <sys/time.h>
+#endif
+
+#include "export.h"
+
+
+class EXPORT RenderTracer
+{
+public:
+	enum EventTypes
+	{
+		PlayHandleJob,
+		AudioPortJob,
+		EffectChannelJob,
+		WaitForJobs,		// barrier inside a period
+		WaitForPeriod,		// idle between periods
+		Period,			// Mixer::renderNextBuffer()
+		FifoWrite,		// handing period over to fifo
+		FifoRead,		// audio device fetching period
+		NumEventTypes
+	} ;
+
+	RenderTracer();
+	~RenderTracer();
+
+	// start recording with given number of lanes - lanes 0 to
+	// _lanes-2 are mixer workers (last one being the thread rendering
+	// periods), lane _lanes-1 is the audio device
+	void start( int _lanes );
+	void stop();
+
+	inline bool isRecording() const
+	{
+		return m_recording;
+	}
+
+	// write recorded events as Chrome trace
+	bool save( const QString & _file ) const;
+
+	// names of ports and channels events are recorded for - render
+	// threads copy them while recording, so they must only be changed
+	// while the mixer is locked; addName() returns -1 if there's no
+	// free slot left
+	int addName( const QString & _name );
+	void setName( int _id, const QString & _name );
+	void removeName( int _id );
+
+	// current time in microseconds
+	static inline qint64 now()
+	{
+		struct timeval tv;
+		gettimeofday( &tv, NULL );
+		return (qint64) tv.tv_sec * 1000000 + tv.tv_usec;
+	}
+
+	// record event which started at _start and ends now - must only be
+	// called by the thread owning _lane, never allocates
+	inline void record( int _lane, EventTypes _type, qint64 _start,
+							int _name = -1 )
+	{
+		if( m_recording )
+		{
+			addEvent( _lane, _type, _start, _name );
+		}
+	}
+
+
+private:
+	enum
+	{
+		NameLength = 32,
+		MaxNames = 1024
+	} ;
+
+	struct Event
+	{
+		qint64 start;
+		int duration;
+		int type;
+		char name[NameLength];
+	} ;
+
+	struct Lane
+	{
+		QVector<Event> events;
+		volatile int count;
+	} ;
+
+	void addEvent( int _lane, EventTypes _type, qint64 _start,
+								int _name );
+
+	QVector<Lane *> m_lanes;
+	char m_names[MaxNames][NameLength];
+	QVector<int> m_freeNames;
+	qint64 m_startTime;
+	volatile bool m_recording;
+
+} ;
+
+
+#endif
@@ -36,6 +36,7 @@
 #include "interpolation.h"
 #include "lmms_basics.h"
 #include "lmms_math.h"
+#include "MemoryPool.h"
 #include "shared_object.h"
 
 
@@ -52,6 +53,8 @@ public:
 		handleState( bool _varying_pitch = false );
 		virtual ~handleState();
 
+		MM_POOLED_ALLOCATION( handleState )
+
 		inline const f_cnt_t frameIndex() const
 		{
 			return m_frameIndex;
@@ -261,9 +264,13 @@ private:
 	float m_frequency;
 	sample_rate_t m_sampleRate;
 
+	// holds fragments wrapping around loop or end of sample - only used
+	// by play() with m_varLock being held
+	sampleFrame * m_fragmentBuffer;
+	f_cnt_t m_fragmentBufferSize;
+
 	sampleFrame * getSampleFragment( f_cnt_t _start, f_cnt_t _frames,
-						bool _looped,
-						sampleFrame * * _tmp ) const;
+							bool _looped );
 	f_cnt_t getLoopedIndex( f_cnt_t _index ) const;
 
 
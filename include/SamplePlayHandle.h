@@ -28,6 +28,7 @@
 #include "Mixer.h"
 #include "SampleBuffer.h"
 #include "AutomatableModel.h"
+#include "MemoryPool.h"
 
 class bbTrack;
 class pattern;
@@ -40,11 +41,15 @@ class SamplePlayHandle : public playHandle
 {
 public:
 	SamplePlayHandle( const QString& sampleFile );
-	SamplePlayHandle( SampleBuffer* sampleBuffer );
+	// creates own audio port unless audioPort is given
+	SamplePlayHandle( SampleBuffer* sampleBuffer,
+						AudioPort * audioPort = NULL );
 	SamplePlayHandle( SampleTCO* tco );
 	SamplePlayHandle( pattern * _pattern );
 	virtual ~SamplePlayHandle();
 
+	MM_POOLED_ALLOCATION( SamplePlayHandle )
+
 	virtual inline bool affinityMatters() const
 	{
 		return true;
@@ -56,6 +61,11 @@ public:
 
 	virtual bool isFromTrack( const track * _track ) const;
 
+	virtual AudioPort * audioPort()
+	{
+		return m_audioPort;
+	}
+
 	f_cnt_t totalFrames() const;
 	inline f_cnt_t framesDone() const
 	{
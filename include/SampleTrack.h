@@ -121,7 +121,7 @@ public:
 	SampleTrack( TrackContainer* tc );
 	virtual ~SampleTrack();
 
-	virtual bool play( const MidiTime & _start, const fpp_t _frames,
+	virtual bool play( const MidiTime & _start, const MidiTime & _end,
 						const f_cnt_t _frame_base, int _tco_num = -1 );
 	virtual trackView * createView( TrackContainerView* tcv );
 	virtual trackContentObject * createTCO( const MidiTime & _pos );
@@ -141,6 +141,12 @@ public:
 		return "sampletrack";
 	}
 
+	virtual void setName( const QString & _new_name );
+
+
+protected:
+	virtual void compileTimeline( EventTimeline & _timeline );
+
 
 private:
 	AudioPort m_audioPort;
@@ -29,8 +29,21 @@
 
 #if QT_VERSION >= 0x040400
 
+#include <QtCore/QAtomicPointer>
+
 typedef QAtomicInt AtomicInt;
 
+template<typename T>
+class AtomicPointer : public QAtomicPointer<T>
+{
+public:
+	inline AtomicPointer( T * _value = 0 ) :
+		QAtomicPointer<T>( _value )
+	{
+	}
+
+} ;
+
 #else
 // implement our own (slow) QAtomicInt class when on old Qt
 class AtomicInt
@@ -68,6 +81,19 @@ public:
 		return oldVal;
 	}
 
+	inline bool testAndSetOrdered( int _expectedVal, int _newVal )
+	{
+		m_lock.lock();
+		const bool match = m_value == _expectedVal;
+		if( match )
+		{
+			m_value = _newVal;
+		}
+		m_lock.unlock();
+
+		return match;
+	}
+
 	inline AtomicInt & operator=( const AtomicInt & _copy )
 	{
 		m_lock.lock();
@@ -97,6 +123,50 @@ private:
 	QMutex m_lock;
 } ;
 
+
+template<typename T>
+class AtomicPointer
+{
+public:
+	inline AtomicPointer( T * _value = 0 ) :
+		m_value( _value ),
+		m_lock()
+	{
+	}
+
+	inline T * fetchAndStoreOrdered( T * _newVal )
+	{
+		m_lock.lock();
+		T * oldVal = m_value;
+		m_value = _newVal;
+		m_lock.unlock();
+
+		return oldVal;
+	}
+
+	inline bool testAndSetOrdered( T * _expectedVal, T * _newVal )
+	{
+		m_lock.lock();
+		const bool match = m_value == _expectedVal;
+		if( match )
+		{
+			m_value = _newVal;
+		}
+		m_lock.unlock();
+
+		return match;
+	}
+
+	inline operator T *() const
+	{
+		return m_value;
+	}
+
+private:
+	T * volatile m_value;
+	QMutex m_lock;
+} ;
+
 #endif
 
 #endif
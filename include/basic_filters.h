@@ -39,6 +39,7 @@
 #include "Mixer.h"
 #include "templates.h"
 #include "lmms_constants.h"
+#include "MemoryPool.h"
 
 //#include <iostream>
 //#include <cstdlib>
@@ -119,6 +120,26 @@ public:
 		delete m_subFilter;
 	}
 
+	// filters are allocated per note while rendering - as the class is a
+	// template, the pool has to be defined inline; created by
+	// engine::initMemoryPools()
+	static MemoryPool & pool()
+	{
+		static MemoryPool * s_pool = new MemoryPool( "basicFilters",
+					sizeof( basicFilters<CHANNELS> ), 1024 );
+		return *s_pool;
+	}
+
+	static void * operator new( size_t _size )
+	{
+		return pool().allocate( _size );
+	}
+
+	static void operator delete( void * _ptr )
+	{
+		pool().deallocate( _ptr );
+	}
+
 	inline void clearHistory()
 	{
 		// reset in/out history
@@ -109,7 +109,7 @@ public:
 	bbTrack( TrackContainer* tc );
 	virtual ~bbTrack();
 
-	virtual bool play( const MidiTime & _start, const fpp_t _frames,
+	virtual bool play( const MidiTime & _start, const MidiTime & _end,
 						const f_cnt_t _frame_base, int _tco_num = -1 );
 	virtual trackView * createView( TrackContainerView* tcv );
 	virtual trackContentObject * createTCO( const MidiTime & _pos );
@@ -38,8 +38,8 @@ public:
 	bbTrackContainer();
 	virtual ~bbTrackContainer();
 
-	virtual bool play( MidiTime _start, const fpp_t _frames,
-						const f_cnt_t _frame_base, int _tco_num = -1 );
+	virtual bool play( const MidiTime & _start, const MidiTime & _end,
+						f_cnt_t _frame_base, int _tco_num = -1 );
 
 	virtual void updateAfterTrackAdd();
 
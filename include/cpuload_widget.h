@@ -59,6 +59,9 @@ private:
 
 	bool m_changed;
 
+	// updates since statistics of audio device were shown last
+	int m_statisticsAge;
+
 	QTimer m_updateTimer;
 
 } ;
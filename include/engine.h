@@ -198,6 +198,7 @@ private:
 	static QMap<QString, QString> s_pluginFileHandling;
 
 	static void initPluginFileHandling();
+	static void initMemoryPools();
 
 } ;
 
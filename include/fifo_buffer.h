@@ -25,61 +25,123 @@
 #ifndef _FIFO_BUFFER_H
 #define _FIFO_BUFFER_H
 
-#include <QtCore/QSemaphore>
+#include "EventCount.h"
+#include "atomic_int.h"
+#include "templates.h"
 
 
+/*! \brief Fixed-size queue for exactly one writing and one reading thread
+ *
+ * Elements are passed without locking - write() only sleeps while the
+ * buffer is full and read() only while it is empty. The number of elements
+ * queued at most can be lowered below the size at runtime via setLimit().
+ */
 template<typename T>
 class fifoBuffer
 {
 public:
 	fifoBuffer( int _size ) :
-		m_reader_sem( _size ),
-		m_writer_sem( _size ),
-		m_reader_index( 0 ),
-		m_writer_index( 0 ),
-		m_size( _size )
+		m_size( _size ),
+		m_buffer( new T[_size+1] ),
+		m_readerIndex( 0 ),
+		m_writerIndex( 0 ),
+		m_limit( _size )
 	{
-		m_buffer = new T[_size];
-		m_reader_sem.acquire( _size );
 	}
 
 	~fifoBuffer()
 	{
 		delete[] m_buffer;
-		m_reader_sem.release( m_size );
 	}
 
 	void write( T _element )
 	{
-		m_writer_sem.acquire();
-		m_buffer[m_writer_index++] = _element;
-		m_writer_index %= m_size;
-		m_reader_sem.release();
+		const int index = m_writerIndex;
+		const int next = index < m_size ? index+1 : 0;
+		while( available() >= m_limit )
+		{
+			const int key = m_readEvent.prepareWait();
+			if( available() < m_limit )
+			{
+				m_readEvent.cancelWait();
+				break;
+			}
+			m_readEvent.wait( key );
+		}
+		m_buffer[index] = _element;
+		m_writerIndex.fetchAndStoreOrdered( next );
+		m_writeEvent.notifyAll();
 	}
 
 	T read()
 	{
-		m_reader_sem.acquire();
-		T element = m_buffer[m_reader_index++];
-		m_reader_index %= m_size;
-		m_writer_sem.release();
+		const int index = m_readerIndex;
+		while( index == m_writerIndex )
+		{
+			const int key = m_writeEvent.prepareWait();
+			if( index != m_writerIndex )
+			{
+				m_writeEvent.cancelWait();
+				break;
+			}
+			m_writeEvent.wait( key );
+		}
+		T element = m_buffer[index];
+		m_readerIndex.fetchAndStoreOrdered( index < m_size ? index+1 : 0 );
+		m_readEvent.notifyAll();
 		return( element );
 	}
 
-	bool available()
+	// number of elements which can be read without waiting
+	int available() const
+	{
+		const int count = m_writerIndex - m_readerIndex;
+		return( count < 0 ? count + m_size + 1 : count );
+	}
+
+	int size() const
 	{
-		return( m_reader_sem.available() );
+		return( m_size );
+	}
+
+	// number of elements queued at most - may be changed while reading
+	// and writing, takes effect with next write()
+	void setLimit( int _limit )
+	{
+		m_limit = tLimit( _limit, 1, m_size );
+		m_readEvent.notifyAll();
+	}
+
+	int limit() const
+	{
+		return( m_limit );
 	}
 
 
 private:
-	QSemaphore m_reader_sem;
-	QSemaphore m_writer_sem;
-	int m_reader_index;
-	int m_writer_index;
-	int m_size;
+	enum
+	{
+		CacheLineSize = 64
+	} ;
+
+	// one slot more than m_size so that a full buffer can be told apart
+	// from an empty one
+	const int m_size;
 	T * m_buffer;
 
+	// keep indices in separate cache lines so reader and writer don't
+	// invalidate each other's cache on every access
+	char m_pad0[CacheLineSize];
+	AtomicInt m_readerIndex;
+	char m_pad1[CacheLineSize];
+	AtomicInt m_writerIndex;
+	char m_pad2[CacheLineSize];
+	volatile int m_limit;
+
+	// notified after reading and after writing respectively
+	EventCount m_readEvent;
+	EventCount m_writeEvent;
+
 } ;
 
 
@@ -32,6 +32,7 @@
 #include "note.h"
 #include "engine.h"
 #include "track.h"
+#include "MemoryPool.h"
 
 
 class InstrumentTrack;
@@ -66,6 +67,10 @@ public:
 					Origin origin = OriginPattern );
 	virtual ~notePlayHandle();
 
+	// note-play-handles are created and destroyed at note rate, partly
+	// by render threads, so don't bother the system allocator with them
+	MM_POOLED_ALLOCATION( notePlayHandle )
+
 	virtual void setVolume( const volume_t volume = DefaultVolume );
 	virtual void setPanning( const panning_t panning = DefaultPanning );
 
@@ -107,6 +112,8 @@ public:
 
 	virtual bool isFromTrack( const track * _track ) const;
 
+	virtual AudioPort * audioPort();
+
 
 	void noteOff( const f_cnt_t _s = 0 );
 
@@ -188,6 +195,9 @@ public:
 	// belonging to this instrument-track - used by arpeggiator
 	int index() const;
 
+	// called by mixer when starting to render this note-play-handle
+	void registerVoice();
+
 	// note-play-handles belonging to given channel, if _all_ph = true,
 	// also released note-play-handles are returned
 	static ConstNotePlayHandleList nphsOfInstrumentTrack(
@@ -237,6 +247,8 @@ private:
 	public:
 		BaseDetuning( DetuningHelper *detuning );
 
+		MM_POOLED_ALLOCATION( BaseDetuning )
+
 		void setValue( float val )
 		{
 			m_value = val;
@@ -293,6 +305,12 @@ private:
 	const int m_midiChannel;
 	const Origin m_origin;
 
+	bool m_voiceRegistered;				// whether we're in
+											// InstrumentTrack::m_voices
+
+
+	friend class engine;
+
 } ;
 
 #endif
@@ -82,6 +82,10 @@ public:
 		return m_notes;
 	}
 
+	// index of first note positioned at or after _pos - cheap when
+	// called for increasing positions as while playing
+	int firstNoteFrom( const MidiTime & _pos ) const;
+
 	void setStep( int _step, bool _enabled );
 
 	// pattern-type stuff
@@ -153,6 +157,8 @@ private:
 
 	// data-stuff
 	NoteVector m_notes;
+	// where last call of firstNoteFrom() ended up
+	mutable int m_noteCursor;
 	int m_steps;
 
 	// pattern freezing
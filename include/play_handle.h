@@ -31,6 +31,8 @@
 #include "lmms_basics.h"
 
 class track;
+class AudioPort;
+class PlayHandleList;
 
 
 class playHandle
@@ -47,7 +49,13 @@ public:
 	playHandle( const types _type, f_cnt_t _offset = 0 ) :
 		m_type( _type ),
 		m_offset( _offset ),
-		m_affinity( QThread::currentThread() )
+		m_affinity( QThread::currentThread() ),
+		m_renderCost( 0 ),
+		m_list( NULL ),
+		m_prev( NULL ),
+		m_next( NULL ),
+		m_nextQueued( NULL ),
+		m_removalRequested( false )
 	{
 	}
 
@@ -88,17 +96,181 @@ public:
 
 	virtual bool isFromTrack( const track * _track ) const = 0;
 
+	// time (in microseconds) it took to render this play-handle in
+	// previous period - the mixer starts most expensive jobs first
+	inline int renderCost() const
+	{
+		return m_renderCost;
+	}
+
+	inline void setRenderCost( int _cost )
+	{
+		m_renderCost = _cost;
+	}
+
+	// returns audio-port this play-handle renders into - the mixer uses
+	// this for scheduling, so if NULL is returned (e.g. because it's
+	// unknown), processing of all audio-ports waits for this play-handle
+	virtual AudioPort * audioPort()
+	{
+		return NULL;
+	}
+
 
 private:
 	types m_type;
 	f_cnt_t m_offset;
 	const QThread * m_affinity;
+	int m_renderCost;
+
+	// links for PlayHandleList
+	PlayHandleList * m_list;
+	playHandle * m_prev;
+	playHandle * m_next;
+
+	// link for the mixer's lock-free queues of play-handles to add or
+	// to remove
+	playHandle * m_nextQueued;
+	volatile bool m_removalRequested;
+
+
+	friend class PlayHandleList;
+	friend class Mixer;
 
 } ;
 
 
-typedef QList<playHandle *> PlayHandleList;
-typedef QList<const playHandle *> ConstPlayHandleList;
+
+// intrusive doubly-linked list of play-handles - keeps order of insertion,
+// removes in O(1) and never allocates
+class PlayHandleList
+{
+public:
+	class Iterator
+	{
+	public:
+		Iterator( playHandle * _ph = NULL ) :
+			m_ph( _ph )
+		{
+		}
+
+		inline playHandle * operator*() const
+		{
+			return m_ph;
+		}
+
+		inline Iterator & operator++()
+		{
+			m_ph = m_ph->m_next;
+			return *this;
+		}
+
+		inline bool operator==( const Iterator & _other ) const
+		{
+			return m_ph == _other.m_ph;
+		}
+
+		inline bool operator!=( const Iterator & _other ) const
+		{
+			return m_ph != _other.m_ph;
+		}
+
+
+	private:
+		playHandle * m_ph;
+
+	} ;
+
+	typedef Iterator ConstIterator;
+
+
+	PlayHandleList() :
+		m_first( NULL ),
+		m_last( NULL ),
+		m_size( 0 )
+	{
+	}
+
+	inline Iterator begin() const
+	{
+		return Iterator( m_first );
+	}
+
+	inline Iterator end() const
+	{
+		return Iterator();
+	}
+
+	inline int size() const
+	{
+		return m_size;
+	}
+
+	inline bool isEmpty() const
+	{
+		return m_size == 0;
+	}
+
+	inline bool contains( const playHandle * _ph ) const
+	{
+		return _ph->m_list == this;
+	}
+
+	inline void push_back( playHandle * _ph )
+	{
+		_ph->m_list = this;
+		_ph->m_prev = m_last;
+		_ph->m_next = NULL;
+		if( m_last )
+		{
+			m_last->m_next = _ph;
+		}
+		else
+		{
+			m_first = _ph;
+		}
+		m_last = _ph;
+		++m_size;
+	}
+
+	inline void remove( playHandle * _ph )
+	{
+		if( _ph->m_prev )
+		{
+			_ph->m_prev->m_next = _ph->m_next;
+		}
+		else
+		{
+			m_first = _ph->m_next;
+		}
+		if( _ph->m_next )
+		{
+			_ph->m_next->m_prev = _ph->m_prev;
+		}
+		else
+		{
+			m_last = _ph->m_prev;
+		}
+		_ph->m_list = NULL;
+		_ph->m_prev = _ph->m_next = NULL;
+		--m_size;
+	}
+
+	// remove play-handle at _it and return iterator to next one
+	inline Iterator erase( Iterator _it )
+	{
+		playHandle * next = ( *_it )->m_next;
+		remove( *_it );
+		return Iterator( next );
+	}
+
+
+private:
+	playHandle * m_first;
+	playHandle * m_last;
+	int m_size;
+
+} ;
 
 
 #endif
@@ -46,6 +46,8 @@ public:
 
 	virtual bool isFromTrack( const track * _track ) const;
 
+	virtual AudioPort * audioPort();
+
 	static void init( void );
 	static void cleanup( void );
 	static ConstNotePlayHandleList nphsOfInstrumentTrack(
@@ -314,6 +314,8 @@ private:
 		return m_playPos[m_playMode].getTicks();
 	}
 	void setPlayPos( tick_t _ticks, PlayModes _play_mode );
+	// compile outdated timelines of all tracks right now
+	void updateTimelines();
 
 	void saveControllerStates( QDomDocument & _doc, QDomElement & _this );
 	void restoreControllerStates( const QDomElement & _this );
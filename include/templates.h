@@ -36,4 +36,48 @@ inline T tLimit( const T x, const T x1, const T x2 )
 }
 
 
+
+// index of first item in _items (ordered by position) which is positioned
+// at or after _pos - _cursor holds where the last call ended up, so when
+// called for increasing positions as while playing only the items passed
+// meanwhile are stepped over, after seeking the rest is binary searched
+template<class C, class P, class F>
+int tFirstFrom( const C & _items, const P & _pos, int & _cursor, F _pos_of )
+{
+	// cursor is still usable if no item before it is at or after _pos
+	int i = _cursor;
+	if( i > _items.size() || ( i > 0 && _pos_of( _items[i-1] ) >= _pos ) )
+	{
+		i = 0;
+	}
+
+	const int maxSteps = 8;
+	int steps = 0;
+	while( i < _items.size() && _pos_of( _items[i] ) < _pos )
+	{
+		if( ++steps > maxSteps )
+		{
+			int hi = _items.size();
+			while( i < hi )
+			{
+				const int mid = ( i + hi ) / 2;
+				if( _pos_of( _items[mid] ) < _pos )
+				{
+					i = mid + 1;
+				}
+				else
+				{
+					hi = mid;
+				}
+			}
+			break;
+		}
+		++i;
+	}
+
+	_cursor = i;
+	return i;
+}
+
+
 #endif
@@ -31,6 +31,7 @@
 #include <QtGui/QWidget>
 
 #include "lmms_basics.h"
+#include "EventTimeline.h"
 #include "MidiTime.h"
 #include "rubberband.h"
 #include "JournallingObject.h"
@@ -382,7 +383,11 @@ public:
 		return m_type;
 	}
 
-	virtual bool play( const MidiTime & _start, const fpp_t _frames,
+	// start everything at positions in [_start, _end) - _start is at frame
+	// _frame_base of current period, following ticks every
+	// engine::framesPerTick() frames; range is empty if no tick starts
+	// within current period
+	virtual bool play( const MidiTime & _start, const MidiTime & _end,
 						const f_cnt_t _frame_base, int _tco_num = -1 ) = 0;
 
 
@@ -405,6 +410,8 @@ public:
 	// -- for usage by trackContentObject only ---------------
 	trackContentObject * addTCO( trackContentObject * _tco );
 	void removeTCO( trackContentObject * _tco );
+	// position or length of _tco changed
+	void updateTCOIndex( trackContentObject * _tco );
 	// -------------------------------------------------------
 
 	int numOfTCOs();
@@ -415,10 +422,21 @@ public:
 	{
 		return( m_trackContentObjects );
 	}
+	// append TCOs overlapping given range to _tco_v, ordered by
+	// position - takes O(log n + k) for k TCOs found
 	void getTCOsInRange( tcoVector & _tco_v, const MidiTime & _start,
 							const MidiTime & _end );
 	void swapPositionOfTCOs( int _tco_num1, int _tco_num2 );
 
+	// events of this track while playing song - for render thread
+	const EventTimeline & timeline() const
+	{
+		return m_timeline->timeline();
+	}
+	// content of a TCO changed, so let compileTimeline() be called on
+	// our thread soon - can be called from any thread
+	void invalidateTimeline();
+
 
 	void insertTact( const MidiTime & _pos );
 	void removeTact( const MidiTime & _pos );
@@ -461,6 +479,18 @@ public slots:
 
 	void toggleSolo();
 
+	// compile timeline again if it's outdated and play it from next
+	// period on
+	void updateTimeline();
+
+
+protected:
+	// add events of all TCOs to _timeline, tracks not using a timeline
+	// don't need to implement this
+	virtual void compileTimeline( EventTimeline & _timeline )
+	{
+	}
+
 
 private:
 	TrackContainer* m_trackContainer;
@@ -476,6 +506,25 @@ private:
 
 	tcoVector m_trackContentObjects;
 
+	// TCOs ordered by start position
+	tcoVector m_tcoIndex;
+	// segment tree over m_tcoIndex holding the latest end position of
+	// the TCOs below each node - node 1 is the root, node n has the
+	// children 2n and 2n+1, leaves start at m_tcoTreeLeaves
+	QVector<tick_t> m_tcoMaxEnd;
+	int m_tcoTreeLeaves;
+
+	EventTimelineSlot * m_timeline;
+	AtomicInt m_timelineOutdated;
+	AtomicInt m_timelineVersion;
+
+	EventTimeline * compileNewTimeline();
+	static void insertIntoTCOIndex( tcoVector & _index,
+					trackContentObject * _tco );
+	void setTCOIndex( tcoVector & _index );
+	void collectTCOs( tcoVector & _tco_v, int _node, int _first,
+				int _last, tick_t _start, int _end_index ) const;
+
 
 	friend class trackView;
 
@@ -484,6 +533,7 @@ signals:
 	void destroyedTrack();
 	void nameChanged();
 	void trackContentObjectAdded( trackContentObject * );
+	void timelineOutdated();
 
 } ;
 
@@ -61,6 +61,11 @@ Plugin::Descriptor PLUGIN_EXPORT bitinvader_plugin_descriptor =
 }
 
 
+MM_POOL_DEFINITION( bSynth, 512 )
+
+
+
+
 bSynth::bSynth( float * _shape, int _length, notePlayHandle * _nph, bool _interpolation,
 				float _factor, const sample_rate_t _sample_rate ) :
 	sample_index( 0 ),
@@ -141,6 +146,8 @@ bitInvader::bitInvader( InstrumentTrack * _instrument_track ) :
 	m_interpolation( false, this ),
 	m_normalize( false, this )
 {
+	// synths are pooled, see MemoryPool.h
+	bSynth::pool();
 
 	m_graph.setWaveToSine();
 
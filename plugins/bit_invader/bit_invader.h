@@ -33,6 +33,7 @@
 #include "knob.h"
 #include "pixmap_button.h"
 #include "led_checkbox.h"
+#include "MemoryPool.h"
 
 class oscillator;
 class bitInvaderView;
@@ -44,6 +45,8 @@ public:
 			bool _interpolation, float factor, 
 			const sample_rate_t _sample_rate );
 	virtual ~bSynth();
+
+	MM_POOLED_ALLOCATION( bSynth )
 	
 	sample_t nextStringSample();
 
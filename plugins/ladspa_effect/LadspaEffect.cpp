@@ -67,6 +67,7 @@ LadspaEffect::LadspaEffect( Model * _parent,
 	Effect( &ladspaeffect_plugin_descriptor, _parent, _key ),
 	m_controls( NULL ),
 	m_maxSampleRate( 0 ),
+	m_planarBuffer( DEFAULT_CHANNELS, engine::mixer()->framesPerPeriod() ),
 	m_key( LadspaSubPluginFeatures::subPluginKeyToLadspaKey( _key ) )
 {
 	ladspa2LMMS * manager = engine::getLADSPAManager();
@@ -153,6 +154,57 @@ bool LadspaEffect::processAudioBuffer( sampleFrame * _buf,
 				engine::mixer()->processingSampleRate();
 	}
 
+	// LADSPA ports are planar anyway
+	m_planarBuffer.resize( frames );
+	m_planarBuffer.fromInterleaved( _buf, frames );
+	runPlugin( m_planarBuffer, frames );
+	m_planarBuffer.toInterleaved( _buf, frames );
+
+	if( o_buf != NULL )
+	{
+		sampleBack( _buf, o_buf, m_maxSampleRate );
+		delete[] _buf;
+	}
+
+	bool is_running = isRunning();
+	m_pluginMutex.unlock();
+	return( is_running );
+}
+
+
+
+
+bool LadspaEffect::supportsPlanarBuffers() const
+{
+	// resampling is done on interleaved buffers
+	return m_maxSampleRate >= engine::mixer()->processingSampleRate();
+}
+
+
+
+
+bool LadspaEffect::processPlanarBuffer( PlanarBuffer & _buf,
+							const fpp_t _frames )
+{
+	m_pluginMutex.lock();
+	if( !isOkay() || dontRun() || !isRunning() || !isEnabled() )
+	{
+		m_pluginMutex.unlock();
+		return( FALSE );
+	}
+
+	runPlugin( _buf, _frames );
+
+	bool is_running = isRunning();
+	m_pluginMutex.unlock();
+	return( is_running );
+}
+
+
+
+
+void LadspaEffect::runPlugin( PlanarBuffer & _buf, const fpp_t _frames )
+{
 	// Copy the LMMS audio buffer to the LADSPA input buffer and initialize
 	// the control ports.  Need to change this to handle non-in-place-broken
 	// plugins--would speed things up to use the same buffer for both
@@ -166,12 +218,8 @@ bool LadspaEffect::processAudioBuffer( sampleFrame * _buf,
 			switch( pp->rate )
 			{
 				case CHANNEL_IN:
-					for( fpp_t frame = 0; 
-						frame < frames; ++frame )
-					{
-						pp->buffer[frame] = 
-							_buf[frame][channel];
-					}
+					memcpy( pp->buffer, _buf.channel( channel ),
+						_frames * sizeof( LADSPA_Data ) );
 					++channel;
 					break;
 				case AUDIO_RATE_INPUT:
@@ -181,7 +229,7 @@ bool LadspaEffect::processAudioBuffer( sampleFrame * _buf,
 					// treated as though they were control rate by setting the
 					// port buffer to all the same value.
 					for( fpp_t frame = 0; 
-						frame < frames; ++frame )
+						frame < _frames; ++frame )
 					{
 						pp->buffer[frame] = 
 							pp->value;
@@ -210,7 +258,7 @@ bool LadspaEffect::processAudioBuffer( sampleFrame * _buf,
 	// Process the buffers.
 	for( ch_cnt_t proc = 0; proc < processorCount(); ++proc )
 	{
-		(m_descriptor->run)( m_handles[proc], frames );
+		(m_descriptor->run)( m_handles[proc], _frames );
 	}
 
 	// Copy the LADSPA output buffers to the LMMS buffer.
@@ -230,20 +278,18 @@ bool LadspaEffect::processAudioBuffer( sampleFrame * _buf,
 				case CONTROL_RATE_INPUT:
 					break;
 				case CHANNEL_OUT:
+				{
+					sample_t * out = _buf.channel( channel );
 					for( fpp_t frame = 0; 
-						frame < frames; ++frame )
+						frame < _frames; ++frame )
 					{
-						_buf[frame][channel] = 
-							d * 
-							_buf[frame][channel] +
-							w *
-							pp->buffer[frame];
-						out_sum += 
-							_buf[frame][channel] *
-							_buf[frame][channel];
+						out[frame] = d * out[frame] +
+							w * pp->buffer[frame];
+						out_sum += out[frame] * out[frame];
 					}
 					++channel;
 					break;
+				}
 				case AUDIO_RATE_OUTPUT:
 				case CONTROL_RATE_OUTPUT:
 					break;
@@ -253,18 +299,7 @@ bool LadspaEffect::processAudioBuffer( sampleFrame * _buf,
 		}
 	}
 
-	if( o_buf != NULL )
-	{
-		sampleBack( _buf, o_buf, m_maxSampleRate );
-		delete[] _buf;
-	}
-
-	checkGate( out_sum / frames );
-
-
-	bool is_running = isRunning();
-	m_pluginMutex.unlock();
-	return( is_running );
+	checkGate( out_sum / _frames );
 }
 
 
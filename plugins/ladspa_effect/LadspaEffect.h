@@ -31,6 +31,7 @@
 #include "Effect.h"
 #include "LadspaBase.h"
 #include "LadspaControls.h"
+#include "PlanarBuffer.h"
 
 
 typedef QVector<port_desc_t *> multi_proc_t;
@@ -45,6 +46,9 @@ public:
 
 	virtual bool processAudioBuffer( sampleFrame * _buf,
 							const fpp_t _frames );
+	virtual bool supportsPlanarBuffers() const;
+	virtual bool processPlanarBuffer( PlanarBuffer & _buf,
+							const fpp_t _frames );
 	
 	void setControl( int _control, LADSPA_Data _data );
 
@@ -66,6 +70,7 @@ private slots:
 private:
 	void pluginInstantiation();
 	void pluginDestruction();
+	void runPlugin( PlanarBuffer & _buf, const fpp_t _frames );
 
 	static sample_rate_t maxSamplerate( const QString & _name );
 
@@ -74,6 +79,9 @@ private:
 	LadspaControls * m_controls;
 
 	sample_rate_t m_maxSampleRate;
+	// used for converting interleaved buffers passed to
+	// processAudioBuffer()
+	PlanarBuffer m_planarBuffer;
 	ladspa_key_t m_key;
 	int m_portCount;
 
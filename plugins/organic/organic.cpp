@@ -73,12 +73,20 @@ QPixmap * organicInstrumentView::s_artwork = NULL;
 ***********************************************************************/
 
 
+MM_POOL_DEFINITION( organicInstrument::oscPtr, 512 )
+
+
+
+
 organicInstrument::organicInstrument( InstrumentTrack * _instrument_track ) :
 	Instrument( _instrument_track, &organic_plugin_descriptor ),
 	m_modulationAlgo( Oscillator::SignalMix ),
 	m_fx1Model( 0.0f, 0.0f, 0.99f, 0.01f , this, tr( "Distortion" ) ),
 	m_volModel( 100.0f, 0.0f, 200.0f, 1.0f, this, tr( "Volume" ) )
 {
+	// per-note oscillators are pooled, see MemoryPool.h
+	oscPtr::pool();
+
 	m_numOscillators = 8;
 
 	m_osc = new OscillatorObject*[ m_numOscillators ];
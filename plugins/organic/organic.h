@@ -30,6 +30,7 @@
 #include "InstrumentView.h"
 #include "Oscillator.h"
 #include "AutomatableModel.h"
+#include "MemoryPool.h"
 
 class QPixmap;
 
@@ -114,6 +115,8 @@ private:
 	
 	struct oscPtr
 	{
+		MM_POOLED_ALLOCATION( oscPtr )
+
 		Oscillator * oscLeft;
 		Oscillator * oscRight;
 	} ;
@@ -73,6 +73,11 @@ Plugin::Descriptor PLUGIN_EXPORT sfxr_plugin_descriptor =
 
 
 
+MM_POOL_DEFINITION( SfxrSynth, 512 )
+
+
+
+
 SfxrSynth::SfxrSynth( const sfxrInstrument * s ):
 	s(s),
 	playing_sample( true )
@@ -347,8 +352,13 @@ sfxrInstrument::sfxrInstrument( InstrumentTrack * _instrument_track ) :
 	m_lpFilResoModel(0.0f, this),
 	m_hpFilCutModel(0.0f, this),
 	m_hpFilCutSweepModel(0.0f, this),
-	m_waveFormModel( SQR_WAVE, 0, WAVES_NUM-1, this, tr( "Wave Form" ) )
+	m_waveFormModel( SQR_WAVE, 0, WAVES_NUM-1, this, tr( "Wave Form" ) ),
+	// enough for notes up to 4 octaves above A4
+	m_pitchedBuffer( new sampleFrame[engine::mixer()->framesPerPeriod() * 16] ),
+	m_pitchedBufferSize( engine::mixer()->framesPerPeriod() * 16 )
 {
+	// synths are pooled, see MemoryPool.h
+	SfxrSynth::pool();
 }
 
 
@@ -356,6 +366,7 @@ sfxrInstrument::sfxrInstrument( InstrumentTrack * _instrument_track ) :
 
 sfxrInstrument::~sfxrInstrument()
 {
+	delete[] m_pitchedBuffer;
 }
 
 
@@ -460,7 +471,13 @@ void sfxrInstrument::playNote( notePlayHandle * _n, sampleFrame * _working_buffe
 	}
 
 	fpp_t pitchedFrameNum = (_n->frequency()/BaseFreq)*frameNum;
-	sampleFrame * pitchedBuffer = new sampleFrame[pitchedFrameNum];
+	if( pitchedFrameNum > m_pitchedBufferSize )
+	{
+		delete[] m_pitchedBuffer;
+		m_pitchedBuffer = new sampleFrame[pitchedFrameNum];
+		m_pitchedBufferSize = pitchedFrameNum;
+	}
+	sampleFrame * pitchedBuffer = m_pitchedBuffer;
 	static_cast<SfxrSynth*>(_n->m_pluginData)->update( pitchedBuffer, pitchedFrameNum );
 	for( fpp_t i=0; i<frameNum; i++ )
 	{
@@ -470,7 +487,6 @@ void sfxrInstrument::playNote( notePlayHandle * _n, sampleFrame * _working_buffe
 		}
 	}
 
-	delete[] pitchedBuffer;
 	m_synthMutex.unlock();
 
 	instrumentTrack()->processAudioBuffer( _working_buffer, frameNum, NULL );
@@ -34,6 +34,7 @@
 #include "graph.h"
 #include "pixmap_button.h"
 #include "led_checkbox.h"
+#include "MemoryPool.h"
 
 
 enum SfxrWaves
@@ -73,6 +74,8 @@ public:
 	SfxrSynth( const sfxrInstrument * s );
 	virtual ~SfxrSynth();
 
+	MM_POOLED_ALLOCATION( SfxrSynth )
+
 	void resetSample( bool restart );
 	void update( sampleFrame * buffer, const fpp_t frameNum );
 
@@ -216,6 +219,11 @@ private:
 
 	IntModel m_waveFormModel;
 
+	// holds note rendered at its own pitch - guarded by m_synthMutex and
+	// only reallocated if a note needs more frames than ever before
+	sampleFrame * m_pitchedBuffer;
+	fpp_t m_pitchedBufferSize;
+
 	friend class sfxrInstrumentView;
 	friend class SfxrSynth;
 };
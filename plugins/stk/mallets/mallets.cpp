@@ -81,6 +81,9 @@ malletsInstrument::malletsInstrument( InstrumentTrack * _instrument_track ):
 		!QFileInfo( configManager::inst()->stkDir() + QDir::separator()
 						+ "sinewave.raw" ).exists() )
 {
+	// synths are pooled, see MemoryPool.h
+	malletsSynth::pool();
+
 	// try to inform user about missing Stk-installation
 	if( m_filesMissing && engine::hasGUI() )
 	{
@@ -513,6 +516,11 @@ void malletsInstrumentView::changePreset()
 
 
 
+MM_POOL_DEFINITION( malletsSynth, 512 )
+
+
+
+
 // ModalBar
 malletsSynth::malletsSynth( const StkFloat _pitch,
 				const StkFloat _velocity,
@@ -35,6 +35,7 @@
 #include "knob.h"
 #include "note_play_handle.h"
 #include "led_checkbox.h"
+#include "MemoryPool.h"
 
 // As of Stk 4.4 all classes and types have been moved to the namespace "stk".
 // However in older versions this namespace does not exist, therefore declare it
@@ -89,6 +90,8 @@ public:
 		delete m_voice;
 	}
 
+	MM_POOLED_ALLOCATION( malletsSynth )
+
 	inline sample_t nextSampleLeft()
 	{
 		if( m_voice == NULL )
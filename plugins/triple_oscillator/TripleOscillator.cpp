@@ -212,6 +212,9 @@ void OscillatorObject::updatePhaseOffsetRight()
 TripleOscillator::TripleOscillator( InstrumentTrack * _instrument_track ) :
 	Instrument( _instrument_track, &tripleoscillator_plugin_descriptor )
 {
+	// per-note oscillators are pooled, see MemoryPool.h
+	oscPtr::pool();
+
 	for( int i = 0; i < NUM_OF_OSCILLATORS; ++i )
 	{
 		m_osc[i] = new OscillatorObject( this, i );
@@ -295,6 +298,11 @@ QString TripleOscillator::nodeName() const
 
 
 
+MM_POOL_DEFINITION( TripleOscillator::oscPtr, 512 )
+
+
+
+
 void TripleOscillator::playNote( notePlayHandle * _n,
 						sampleFrame * _working_buffer )
 {
@@ -30,6 +30,7 @@
 #include "InstrumentView.h"
 #include "Oscillator.h"
 #include "AutomatableModel.h"
+#include "MemoryPool.h"
 
 
 class automatableButtonGroup;
@@ -125,6 +126,8 @@ private:
 
 	struct oscPtr
 	{
+		MM_POOLED_ALLOCATION( oscPtr )
+
 		Oscillator * oscLeft;
 		Oscillator * oscRight;
 	} ;
@@ -25,6 +25,11 @@
 #include "string_container.h"
 
 
+MM_POOL_DEFINITION( stringContainer, 512 )
+
+
+
+
 stringContainer::stringContainer(const float _pitch, 
 				const sample_rate_t _sample_rate,
 				const int _buffer_length,
@@ -27,6 +27,7 @@
 #include <QtCore/QVector>
 
 #include "vibrating_string.h"
+#include "MemoryPool.h"
 
 
 
@@ -62,6 +63,8 @@ public:
 			delete m_strings[i];
 		}
 	}
+
+	MM_POOLED_ALLOCATION( stringContainer )
 	
 	float getStringSample( int _string )
 	{
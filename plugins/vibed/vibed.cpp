@@ -65,6 +65,8 @@ Plugin::Descriptor PLUGIN_EXPORT vibedstrings_plugin_descriptor =
 vibed::vibed( InstrumentTrack * _instrumentTrack ) :
 	Instrument( _instrumentTrack, &vibedstrings_plugin_descriptor )
 {
+	// string containers are pooled, see MemoryPool.h
+	stringContainer::pool();
 
 	FloatModel * knob;
 	BoolModel * led;
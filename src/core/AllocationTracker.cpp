@@ -0,0 +1,265 @@
+/*
+ * AllocationTracker.cpp - find heap usage of render threads
+ *
+ * Copyright (c) 2014 Tobias Doerffel <tobydox/at/users.sourceforge.net>
+ *
+ * This file is part of Linux MultiMedia Studio - http://lmms.sourceforge.net
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "AllocationTracker.h"
+#include "lmmsconfig.h"
+
+
+#if defined(LMMS_DEBUG_ALLOCATIONS) && defined(__GLIBC__)
+
+#include <cstring>
+#include <execinfo.h>
+
+#include "atomic_int.h"
+
+
+enum CallTypes
+{
+	Call_Malloc,
+	Call_Calloc,
+	Call_Realloc,
+	Call_Free
+} ;
+
+static const char * callNames[] = { "malloc", "calloc", "realloc", "free" };
+
+static const int MaxRecords = 4096;
+static const int MaxFrames = 12;
+// frames belonging to record() and the replaced function itself
+static const int SkippedFrames = 2;
+
+struct Record
+{
+	CallTypes type;
+	size_t size;
+	int depth;
+	void * frames[MaxFrames];
+} ;
+
+static Record s_records[MaxRecords];
+static AtomicInt s_recordCount;
+
+static volatile bool s_inPeriod = false;
+static __thread bool s_renderThread = false;
+// set while recording so that allocations done by backtrace() itself are
+// not recorded
+static __thread bool s_recording = false;
+
+
+
+static void record( CallTypes _type, size_t _size )
+{
+	if( !s_renderThread || !s_inPeriod || s_recording )
+	{
+		return;
+	}
+	s_recording = true;
+	const int i = s_recordCount.fetchAndAddOrdered( 1 );
+	if( i < MaxRecords )
+	{
+		Record & r = s_records[i];
+		r.type = _type;
+		r.size = _size;
+		r.depth = backtrace( r.frames, MaxFrames );
+	}
+	s_recording = false;
+}
+
+
+
+
+extern "C"
+{
+
+extern void * __libc_malloc( size_t _size );
+extern void * __libc_calloc( size_t _n, size_t _size );
+extern void * __libc_realloc( void * _ptr, size_t _size );
+extern void __libc_free( void * _ptr );
+
+
+void * malloc( size_t _size )
+{
+	record( Call_Malloc, _size );
+	return __libc_malloc( _size );
+}
+
+
+
+
+void * calloc( size_t _n, size_t _size )
+{
+	record( Call_Calloc, _n * _size );
+	return __libc_calloc( _n, _size );
+}
+
+
+
+
+void * realloc( void * _ptr, size_t _size )
+{
+	record( Call_Realloc, _size );
+	return __libc_realloc( _ptr, _size );
+}
+
+
+
+
+void free( void * _ptr )
+{
+	if( _ptr != NULL )
+	{
+		record( Call_Free, 0 );
+	}
+	__libc_free( _ptr );
+}
+
+}
+
+
+
+
+static bool sameCallSite( const Record & _a, const Record & _b )
+{
+	return _a.type == _b.type && _a.depth == _b.depth &&
+		memcmp( _a.frames, _b.frames,
+				_a.depth * sizeof( void * ) ) == 0;
+}
+
+
+
+
+void AllocationTracker::registerRenderThread()
+{
+	s_renderThread = true;
+}
+
+
+
+
+void AllocationTracker::beginPeriod()
+{
+	s_renderThread = true;
+	s_inPeriod = true;
+}
+
+
+
+
+void AllocationTracker::endPeriod()
+{
+	s_inPeriod = false;
+}
+
+
+
+
+void AllocationTracker::report()
+{
+	const int total = s_recordCount;
+	const int recorded = total < MaxRecords ? total : MaxRecords;
+	if( total == 0 )
+	{
+		printf( "No heap usage on render threads recorded.\n" );
+		return;
+	}
+
+	printf( "%d heap calls on render threads recorded", total );
+	if( total > recorded )
+	{
+		printf( " (call sites of %d calls dropped)", total - recorded );
+	}
+	printf( ":\n" );
+
+	for( int i = 0; i < recorded; ++i )
+	{
+		int count = 0;
+		bool reported = false;
+		for( int j = 0; j < recorded; ++j )
+		{
+			if( sameCallSite( s_records[i], s_records[j] ) )
+			{
+				if( j < i )
+				{
+					reported = true;
+					break;
+				}
+				++count;
+			}
+		}
+		if( reported )
+		{
+			continue;
+		}
+
+		const Record & r = s_records[i];
+		printf( "\n%dx %s\n", count, callNames[r.type] );
+		if( r.depth > SkippedFrames )
+		{
+			char * * symbols = backtrace_symbols(
+						r.frames + SkippedFrames,
+						r.depth - SkippedFrames );
+			for( int f = 0; f < r.depth - SkippedFrames; ++f )
+			{
+				printf( "    %s\n", symbols ? symbols[f] : "?" );
+			}
+			free( symbols );
+		}
+	}
+}
+
+
+#else
+
+
+void AllocationTracker::registerRenderThread()
+{
+}
+
+
+
+
+void AllocationTracker::beginPeriod()
+{
+}
+
+
+
+
+void AllocationTracker::endPeriod()
+{
+}
+
+
+
+
+void AllocationTracker::report()
+{
+}
+
+
+#endif
+
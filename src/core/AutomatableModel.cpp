@@ -27,9 +27,12 @@
 #include "AutomatableModel.h"
 #include "AutomationPattern.h"
 #include "ControllerConnection.h"
+#include "engine.h"
+#include "Mixer.h"
 
 
 float AutomatableModel::s_copiedValue = 0;
+int AutomatableModel::s_period = 0;
 
 
 
@@ -49,7 +52,9 @@ AutomatableModel::AutomatableModel( DataType type,
 	m_journalEntryReady( false ),
 	m_setValueDepth( 0 ),
 	m_hasLinkedModels( false ),
-	m_controllerConnection( NULL )
+	m_controllerConnection( NULL ),
+	m_valueBuffer( NULL ),
+	m_valueBufferPeriod( -1 )
 {
 	setInitValue( val );
 }
@@ -70,6 +75,8 @@ AutomatableModel::~AutomatableModel()
 		delete m_controllerConnection;
 	}
 
+	delete[] m_valueBuffer;
+
 	emit destroyed( id() );
 }
 
@@ -237,6 +244,59 @@ void AutomatableModel::setAutomatedValue( const float value )
 
 
 
+void AutomatableModel::setAutomatedValues( const float * values,
+							const f_cnt_t from )
+{
+	const fpp_t frames = engine::mixer()->framesPerPeriod();
+	if( m_valueBuffer == NULL )
+	{
+		// not prepared, so we can't do better than one value
+		setAutomatedValue( values[frames - 1] );
+		return;
+	}
+	if( m_valueBufferPeriod != s_period )
+	{
+		// first values for this period - frames before keep current
+		// value, so if nothing changes stay with scalar value
+		bool constant = from == 0 || values[from] == m_value;
+		for( f_cnt_t f = from + 1; constant && f < frames; ++f )
+		{
+			constant = values[f] == values[from];
+		}
+		if( constant )
+		{
+			setAutomatedValue( values[from] );
+			return;
+		}
+
+		for( f_cnt_t f = 0; f < from; ++f )
+		{
+			m_valueBuffer[f] = m_value;
+		}
+		m_valueBufferPeriod = s_period;
+	}
+
+	for( f_cnt_t f = from; f < frames; ++f )
+	{
+		m_valueBuffer[f] = fittedValue( values[f] );
+	}
+	setAutomatedValue( values[frames - 1] );
+}
+
+
+
+
+void AutomatableModel::prepareValueBuffer()
+{
+	if( m_valueBuffer == NULL )
+	{
+		m_valueBuffer = new float[engine::mixer()->framesPerPeriod()];
+	}
+}
+
+
+
+
 void AutomatableModel::setRange( const float min, const float max,
 							const float step )
 {
@@ -32,9 +32,12 @@
 #include "AutomationPatternView.h"
 #include "AutomationEditor.h"
 #include "AutomationTrack.h"
+#include "engine.h"
+#include "Mixer.h"
 #include "ProjectJournal.h"
 #include "bb_track_container.h"
 #include "song.h"
+#include "templates.h"
 
 
 
@@ -109,6 +112,7 @@ void AutomationPattern::addObject( AutomatableModel * _obj, bool _search_dup )
 			putValue( 0, _obj->value<float>(), false );
 		}
 
+		_obj->prepareValueBuffer();
 		m_objects += _obj;
 
 		connect( _obj, SIGNAL( destroyed( jo_id_t ) ),
@@ -417,19 +421,79 @@ const QString AutomationPattern::name() const
 
 
 
-void AutomationPattern::processMidiTime( const MidiTime & _time )
+void AutomationPattern::processPeriod( const MidiTime & _pos,
+				const f_cnt_t _frame_base, const f_cnt_t _from,
+				const MidiTime & _end, float * _values )
 {
-	if( _time >= 0 && hasAutomation() )
+	if( !hasAutomation() )
 	{
-		const float val = valueAt( _time );
-		for( objectVector::iterator it = m_objects.begin();
-						it != m_objects.end(); ++it )
+		return;
+	}
+
+	const fpp_t frames = engine::mixer()->framesPerPeriod();
+	const float frames_per_tick = engine::framesPerTick();
+	// nothing changes after last value
+	const tick_t last = qMin<tick_t>( _end, ( m_timeMap.end() - 1 ).key() );
+
+	// frames before start of pattern are left alone, so they keep the
+	// current value of the models - if pattern starts with this call,
+	// frames before _frame_base still belong to the tick before it
+	f_cnt_t f = _from;
+	if( _pos <= 0 )
+	{
+		f = qMax<f_cnt_t>( f, _frame_base + static_cast<f_cnt_t>(
+					ceilf( -_pos * frames_per_tick ) ) );
+	}
+	const f_cnt_t first = f;
+	if( first >= frames )
+	{
+		return;
+	}
+
+	// evaluate pattern at full ticks only and interpolate linearly in
+	// between, valueAt() is too expensive for doing it for every frame
+	const float x = _frame_base - _pos * frames_per_tick;	// position 0
+	while( f < frames )
+	{
+		const tick_t tick = qMin<tick_t>( static_cast<tick_t>(
+				( f - x ) / frames_per_tick ), last );
+		// frame at which tick starts
+		const float x_tick = x + tick * frames_per_tick;
+		const float v1 = valueAt( tick );
+		if( tick >= last )
+		{
+			for( ; f < frames; ++f )
+			{
+				_values[f] = v1;
+			}
+			break;
+		}
+
+		const f_cnt_t next = tLimit<f_cnt_t>( static_cast<f_cnt_t>(
+				ceilf( x_tick + frames_per_tick ) ), f + 1, frames );
+		if( m_progressionType == DiscreteProgression )
 		{
-			if( *it )
+			for( ; f < next; ++f )
 			{
-				( *it )->setAutomatedValue( val );
+				_values[f] = v1;
 			}
+			continue;
+		}
+
+		const float slope = ( valueAt( tick + 1 ) - v1 ) /
+							frames_per_tick;
+		for( ; f < next; ++f )
+		{
+			_values[f] = v1 + ( f - x_tick ) * slope;
+		}
+	}
 
+	for( objectVector::iterator it = m_objects.begin();
+					it != m_objects.end(); ++it )
+	{
+		if( *it )
+		{
+			( *it )->setAutomatedValues( _values, first );
 		}
 	}
 }
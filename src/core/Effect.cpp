@@ -33,6 +33,7 @@
 #include "DummyEffect.h"
 #include "EffectChain.h"
 #include "EffectView.h"
+#include "RealtimeLog.h"
 
 
 Effect::Effect( const Plugin::Descriptor * _desc,
@@ -48,7 +49,8 @@ Effect::Effect( const Plugin::Descriptor * _desc,
 	m_enabledModel( true, this, tr( "Effect enabled" ) ),
 	m_wetDryModel( 1.0f, -1.0f, 1.0f, 0.01f, this, tr( "Wet/Dry mix" ) ),
 	m_gateModel( 0.0f, 0.0f, 1.0f, 0.01f, this, tr( "Gate" ) ),
-	m_autoQuitModel( 1.0f, 1.0f, 8000.0f, 100.0f, 1.0f, this, tr( "Decay" ) )
+	m_autoQuitModel( 1.0f, 1.0f, 8000.0f, 100.0f, 1.0f, this, tr( "Decay" ) ),
+	m_profile()
 {
 	m_srcState[0] = m_srcState[1] = NULL;
 	reinitSRC();
@@ -198,8 +200,8 @@ void Effect::resample( int _i, const sampleFrame * _src_buf,
 	int error;
 	if( ( error = src_process( m_srcState[_i], &m_srcData[_i] ) ) )
 	{
-		fprintf( stderr, "Effect::resample(): error while resampling: %s\n",
-							src_strerror( error ) );
+		RealtimeLog::post( "Effect::resample(): error while "
+				"resampling: %s", src_strerror( error ) );
 	}
 }
 
@@ -30,14 +30,43 @@
 #include "Effect.h"
 #include "engine.h"
 #include "debug.h"
+#include "MicroTimer.h"
 #include "DummyEffect.h"
+#include "RealtimeLog.h"
+
+
+// swaps list of effects - old list is released with the command, i.e. not
+// by render thread
+class EffectListCommand : public RealtimeCommand
+{
+public:
+	EffectListCommand( QVector<Effect *> & _target,
+					const QVector<Effect *> & _effects ) :
+		m_target( _target ),
+		m_effects( _effects )
+	{
+	}
+
+	virtual void execute()
+	{
+		qSwap( m_target, m_effects );
+	}
+
+
+private:
+	QVector<Effect *> & m_target;
+	QVector<Effect *> m_effects;
+
+} ;
+
 
 
 
 EffectChain::EffectChain( Model * _parent ) :
 	Model( _parent ),
 	SerializingObject(),
-	m_enabledModel( false, NULL, tr( "Effects enabled" ) )
+	m_enabledModel( false, NULL, tr( "Effects enabled" ) ),
+	m_planarBuffer( DEFAULT_CHANNELS, engine::mixer()->framesPerPeriod() )
 {
 }
 
@@ -56,8 +85,8 @@ void EffectChain::saveSettings( QDomDocument & _doc, QDomElement & _this )
 {
 	_this.setAttribute( "enabled", m_enabledModel.value() );
 	_this.setAttribute( "numofeffects", m_effects.count() );
-	for( EffectList::Iterator it = m_effects.begin(); 
-					it != m_effects.end(); it++ )
+	for( EffectList::ConstIterator it = m_effects.constBegin(); 
+					it != m_effects.constEnd(); it++ )
 	{
 		QDomElement ef = ( *it )->saveState( _doc, _this );
 		ef.setAttribute( "name", ( *it )->descriptor()->name );
@@ -114,11 +143,23 @@ void EffectChain::loadSettings( const QDomElement & _this )
 
 
 
+// deep copy of current effects - implicitly sharing m_effects would make the
+// render thread detach (i.e. allocate) it as soon as it iterates it
+static QVector<Effect *> copyOf( const QVector<Effect *> & _list )
+{
+	QVector<Effect *> effects( _list.size() );
+	qCopy( _list.constBegin(), _list.constEnd(), effects.begin() );
+	return effects;
+}
+
+
+
+
 void EffectChain::appendEffect( Effect * _effect )
 {
-	engine::mixer()->lock();
-	m_effects.append( _effect );
-	engine::mixer()->unlock();
+	EffectList effects = copyOf( m_effects );
+	effects.append( _effect );
+	setEffects( effects );
 
 	emit dataChanged();
 }
@@ -128,9 +169,9 @@ void EffectChain::appendEffect( Effect * _effect )
 
 void EffectChain::removeEffect( Effect * _effect )
 {
-	engine::mixer()->lock();
-	m_effects.erase( qFind( m_effects.begin(), m_effects.end(), _effect ) );
-	engine::mixer()->unlock();
+	EffectList effects = copyOf( m_effects );
+	effects.erase( qFind( effects.begin(), effects.end(), _effect ) );
+	setEffects( effects );
 }
 
 
@@ -138,21 +179,13 @@ void EffectChain::removeEffect( Effect * _effect )
 
 void EffectChain::moveDown( Effect * _effect )
 {
-	if( _effect != m_effects.last() )
+	const int i = m_effects.indexOf( _effect );
+	if( i >= 0 && i < m_effects.size() - 1 )
 	{
-		int i = 0;
-		for( EffectList::Iterator it = m_effects.begin(); 
-					it != m_effects.end(); it++, i++ )
-		{
-			if( *it == _effect )
-			{
-				break;
-			}
-		}
-		
-		Effect * temp = m_effects[i + 1];
-		m_effects[i + 1] = _effect;
-		m_effects[i] = temp;	
+		EffectList effects = copyOf( m_effects );
+		effects[i] = effects[i + 1];
+		effects[i + 1] = _effect;
+		setEffects( effects );
 	}
 }
 
@@ -161,58 +194,112 @@ void EffectChain::moveDown( Effect * _effect )
 
 void EffectChain::moveUp( Effect * _effect )
 {
-	if( _effect != m_effects.first() )
+	const int i = m_effects.indexOf( _effect );
+	if( i > 0 )
 	{
-		int i = 0;
-		for( EffectList::Iterator it = m_effects.begin(); 
-					it != m_effects.end(); it++, i++ )
-		{
-			if( *it == _effect )
-			{
-				break;
-			}
-		}
-		
-		Effect * temp = m_effects[i - 1];
-		m_effects[i - 1] = _effect;
-		m_effects[i] = temp;	
+		EffectList effects = copyOf( m_effects );
+		effects[i] = effects[i - 1];
+		effects[i - 1] = _effect;
+		setEffects( effects );
 	}
 }
 
 
 
 
+void EffectChain::setEffects( const EffectList & _effects )
+{
+	engine::mixer()->commandQueue().postAndWait(
+			new EffectListCommand( m_effects, _effects ) );
+}
+
+
+
+
 bool EffectChain::processAudioBuffer( sampleFrame * _buf, const fpp_t _frames )
 {
 	if( m_enabledModel.value() == false )
 	{
 		return false;
 	}
+	// only grows if period size was changed
+	m_planarBuffer.resize( _frames );
+
 	bool moreEffects = false;
-	for( EffectList::Iterator it = m_effects.begin(); 
-						it != m_effects.end(); ++it )
+	// whether current signal is in m_planarBuffer instead of _buf - this
+	// way it's only converted between subsequent effects if they don't
+	// support the same buffer layout
+	bool planar = false;
+	for( EffectList::ConstIterator it = m_effects.constBegin(); 
+						it != m_effects.constEnd(); ++it )
 	{
-		moreEffects |= ( *it )->processAudioBuffer( _buf, _frames );
+		// effects stop running once their tail has decayed below
+		// their gate - they don't touch the buffer then anyway
+		if( !( *it )->isRunning() )
+		{
+			continue;
+		}
+		MicroTimer timer;
+		if( ( *it )->supportsPlanarBuffers() )
+		{
+			if( !planar )
+			{
+				m_planarBuffer.fromInterleaved( _buf, _frames );
+				planar = true;
+			}
+			moreEffects |= ( *it )->processPlanarBuffer(
+						m_planarBuffer, _frames );
+		}
+		else
+		{
+			if( planar )
+			{
+				m_planarBuffer.toInterleaved( _buf, _frames );
+				planar = false;
+			}
+			moreEffects |= ( *it )->processAudioBuffer( _buf,
+								_frames );
+		}
+		( *it )->m_profile.add( timer.elapsed() );
 #ifdef LMMS_DEBUG
+		if( planar )
+		{
+			continue;
+		}
 		for( int f = 0; f < _frames; ++f )
 		{
 			if( fabs( _buf[f][0] ) > 5 || fabs( _buf[f][1] ) > 5 )
 			{
-				it = m_effects.end()-1;
-				printf( "numerical overflow after processing "
-					"plugin \"%s\"\n", ( *it )->
-					publicName().toUtf8().constData() );
+				RealtimeLog::post( "numerical overflow after "
+					"processing plugin \"%s\"",
+					( *it )->descriptor()->displayName );
 				break;
 			}
 		}
 #endif
 	}
+	if( planar )
+	{
+		m_planarBuffer.toInterleaved( _buf, _frames );
+	}
 	return moreEffects;
 }
 
 
 
 
+void EffectChain::finishProfilingPeriod()
+{
+	for( EffectList::ConstIterator it = m_effects.constBegin();
+						it != m_effects.constEnd(); ++it )
+	{
+		( *it )->m_profile.finishPeriod();
+	}
+}
+
+
+
+
 void EffectChain::startRunning()
 {
 	if( m_enabledModel.value() == false )
@@ -220,8 +307,8 @@ void EffectChain::startRunning()
 		return;
 	}
 	
-	for( EffectList::Iterator it = m_effects.begin(); 
-						it != m_effects.end(); it++ )
+	for( EffectList::ConstIterator it = m_effects.constBegin(); 
+						it != m_effects.constEnd(); it++ )
 	{
 		( *it )->startRunning();
 	}
@@ -237,14 +324,15 @@ bool EffectChain::isRunning()
 		return false;
 	}
 	
-	bool running = false;
-	
-	for( EffectList::Iterator it = m_effects.begin(); 
-				it != m_effects.end() || !running; it++ )
+	for( EffectList::ConstIterator it = m_effects.constBegin(); 
+						it != m_effects.constEnd(); ++it )
 	{
-		running = ( *it )->isRunning() && running;
+		if( ( *it )->isRunning() )
+		{
+			return true;
+		}
 	}
-	return running;
+	return false;
 }
 
 
@@ -41,6 +41,62 @@ extern const float SECS_PER_LFO_OSCILLATION = 20.0f;
 EnvelopeAndLfoParameters::LfoInstances * EnvelopeAndLfoParameters::s_lfoInstances = NULL;
 
 
+// values and tables computed by updateSampleVars() - the tables replaced
+// are freed along with the command
+class EnvelopeAndLfoParameters::SampleVarsCommand : public RealtimeCommand
+{
+public:
+	SampleVarsCommand( EnvelopeAndLfoParameters * _params ) :
+		m_params( _params ),
+		m_pahdEnv( NULL ),
+		m_rEnv( NULL )
+	{
+	}
+
+	virtual ~SampleVarsCommand()
+	{
+		delete[] m_pahdEnv;
+		delete[] m_rEnv;
+	}
+
+	virtual void execute()
+	{
+		EnvelopeAndLfoParameters * p = m_params;
+		p->m_used = m_used;
+		p->m_sustainLevel = m_sustainLevel;
+		p->m_amount = m_amount;
+		p->m_amountAdd = m_amountAdd;
+		p->m_pahdFrames = m_pahdFrames;
+		p->m_rFrames = m_rFrames;
+		qSwap( p->m_pahdEnv, m_pahdEnv );
+		qSwap( p->m_rEnv, m_rEnv );
+		p->m_lfoPredelayFrames = m_lfoPredelayFrames;
+		p->m_lfoAttackFrames = m_lfoAttackFrames;
+		p->m_lfoOscillationFrames = m_lfoOscillationFrames;
+		p->m_lfoAmount = m_lfoAmount;
+		p->m_lfoAmountIsZero = m_lfoAmountIsZero;
+		p->m_bad_lfoShapeData = true;
+	}
+
+	EnvelopeAndLfoParameters * m_params;
+
+	bool m_used;
+	float m_sustainLevel;
+	float m_amount;
+	float m_amountAdd;
+	f_cnt_t m_pahdFrames;
+	f_cnt_t m_rFrames;
+	sample_t * m_pahdEnv;
+	sample_t * m_rEnv;
+	f_cnt_t m_lfoPredelayFrames;
+	f_cnt_t m_lfoAttackFrames;
+	f_cnt_t m_lfoOscillationFrames;
+	float m_lfoAmount;
+	bool m_lfoAmountIsZero;
+
+} ;
+
+
 void EnvelopeAndLfoParameters::LfoInstances::trigger()
 {
 	QMutexLocker m( &m_lfoListMutex );
@@ -383,7 +439,8 @@ void EnvelopeAndLfoParameters::loadSettings( const QDomElement & _this )
 
 void EnvelopeAndLfoParameters::updateSampleVars()
 {
-	engine::mixer()->lock();
+	// tables are built here and only swapped in by the render thread
+	SampleVarsCommand * cmd = new SampleVarsCommand( this );
 
 	const float frames_per_env_seg = SECS_PER_ENV_SEGMENT *
 				engine::mixer()->processingSampleRate();
@@ -402,112 +459,118 @@ void EnvelopeAndLfoParameters::updateSampleVars()
 					expKnobVal( m_decayModel.value() *
 						m_sustainModel.value() ) );
 
-	m_sustainLevel = 1.0f - m_sustainModel.value();
-	m_amount = m_amountModel.value();
-	if( m_amount >= 0 )
+	float sustain_level = 1.0f - m_sustainModel.value();
+	const float amount = m_amountModel.value();
+	float amount_add;
+	if( amount >= 0 )
 	{
-		m_amountAdd = ( 1.0f - m_amount ) * m_valueForZeroAmount;
+		amount_add = ( 1.0f - amount ) * m_valueForZeroAmount;
 	}
 	else
 	{
-		m_amountAdd = m_valueForZeroAmount;
+		amount_add = m_valueForZeroAmount;
 	}
 
-	m_pahdFrames = predelay_frames + attack_frames + hold_frames +
-								decay_frames;
-	m_rFrames = static_cast<f_cnt_t>( frames_per_env_seg *
+	const f_cnt_t pahd_frames = predelay_frames + attack_frames +
+						hold_frames + decay_frames;
+	f_cnt_t r_frames = static_cast<f_cnt_t>( frames_per_env_seg *
 					expKnobVal( m_releaseModel.value() ) );
 
-	if( static_cast<int>( floorf( m_amount * 1000.0f ) ) == 0 )
+	if( static_cast<int>( floorf( amount * 1000.0f ) ) == 0 )
 	{
-		//m_pahdFrames = 0;
-		m_rFrames = 0;
+		//pahd_frames = 0;
+		r_frames = 0;
 	}
 
-	delete[] m_pahdEnv;
-	delete[] m_rEnv;
-
-	m_pahdEnv = new sample_t[m_pahdFrames];
-	m_rEnv = new sample_t[m_rFrames];
+	sample_t * pahd_env = new sample_t[pahd_frames];
+	sample_t * r_env = new sample_t[r_frames];
 
-	const float aa = m_amountAdd;
+	const float aa = amount_add;
 	for( f_cnt_t i = 0; i < predelay_frames; ++i )
 	{
-		m_pahdEnv[i] = aa;
+		pahd_env[i] = aa;
 	}
 
 	f_cnt_t add = predelay_frames;
 
-	const float afI = ( 1.0f / attack_frames ) * m_amount;
+	const float afI = ( 1.0f / attack_frames ) * amount;
 	for( f_cnt_t i = 0; i < attack_frames; ++i )
 	{
-		m_pahdEnv[add+i] = i * afI + aa;
+		pahd_env[add+i] = i * afI + aa;
 	}
 
 	add += attack_frames;
-	const float amsum = m_amount + m_amountAdd;
+	const float amsum = amount + amount_add;
 	for( f_cnt_t i = 0; i < hold_frames; ++i )
 	{
-		m_pahdEnv[add + i] = amsum;
+		pahd_env[add + i] = amsum;
 	}
 
 	add += hold_frames;
-	const float dfI = (1.0 / decay_frames)*(m_sustainLevel-1)*m_amount;
+	const float dfI = (1.0 / decay_frames)*(sustain_level-1)*amount;
 	for( f_cnt_t i = 0; i < decay_frames; ++i )
 	{
 /*
-		m_pahdEnv[add + i] = ( m_sustainLevel + ( 1.0f -
+		pahd_env[add + i] = ( sustain_level + ( 1.0f -
 						(float)i / decay_frames ) *
-						( 1.0f - m_sustainLevel ) ) *
-							m_amount + m_amountAdd;
+						( 1.0f - sustain_level ) ) *
+							amount + amount_add;
 */
-		m_pahdEnv[add + i] = amsum + i*dfI;
+		pahd_env[add + i] = amsum + i*dfI;
 	}
 
-	const float rfI = ( 1.0f / m_rFrames ) * m_amount;
-	for( f_cnt_t i = 0; i < m_rFrames; ++i )
+	const float rfI = ( 1.0f / r_frames ) * amount;
+	for( f_cnt_t i = 0; i < r_frames; ++i )
 	{
-		m_rEnv[i] = (float)( m_rFrames - i ) * rfI;
+		r_env[i] = (float)( r_frames - i ) * rfI;
 	}
 
 	// save this calculation in real-time-part
-	m_sustainLevel = m_sustainLevel * m_amount + m_amountAdd;
+	sustain_level = sustain_level * amount + amount_add;
 
 
 	const float frames_per_lfo_oscillation = SECS_PER_LFO_OSCILLATION *
 				engine::mixer()->processingSampleRate();
-	m_lfoPredelayFrames = static_cast<f_cnt_t>( frames_per_lfo_oscillation *
+	cmd->m_lfoPredelayFrames = static_cast<f_cnt_t>(
+					frames_per_lfo_oscillation *
 				expKnobVal( m_lfoPredelayModel.value() ) );
-	m_lfoAttackFrames = static_cast<f_cnt_t>( frames_per_lfo_oscillation *
+	cmd->m_lfoAttackFrames = static_cast<f_cnt_t>(
+					frames_per_lfo_oscillation *
 				expKnobVal( m_lfoAttackModel.value() ) );
-	m_lfoOscillationFrames = static_cast<f_cnt_t>(
+	cmd->m_lfoOscillationFrames = static_cast<f_cnt_t>(
 						frames_per_lfo_oscillation *
 						m_lfoSpeedModel.value() );
 	if( m_x100Model.value() )
 	{
-		m_lfoOscillationFrames /= 100;
+		cmd->m_lfoOscillationFrames /= 100;
 	}
-	m_lfoAmount = m_lfoAmountModel.value() * 0.5f;
+	cmd->m_lfoAmount = m_lfoAmountModel.value() * 0.5f;
 
-	m_used = true;
-	if( static_cast<int>( floorf( m_lfoAmount * 1000.0f ) ) == 0 )
+	cmd->m_used = true;
+	if( static_cast<int>( floorf( cmd->m_lfoAmount * 1000.0f ) ) == 0 )
 	{
-		m_lfoAmountIsZero = true;
-		if( static_cast<int>( floorf( m_amount * 1000.0f ) ) == 0 )
+		cmd->m_lfoAmountIsZero = true;
+		if( static_cast<int>( floorf( amount * 1000.0f ) ) == 0 )
 		{
-			m_used = false;
+			cmd->m_used = false;
 		}
 	}
 	else
 	{
-		m_lfoAmountIsZero = false;
+		cmd->m_lfoAmountIsZero = false;
 	}
 
-	m_bad_lfoShapeData = true;
+	cmd->m_sustainLevel = sustain_level;
+	cmd->m_amount = amount;
+	cmd->m_amountAdd = amount_add;
+	cmd->m_pahdFrames = pahd_frames;
+	cmd->m_rFrames = r_frames;
+	cmd->m_pahdEnv = pahd_env;
+	cmd->m_rEnv = r_env;
 
-	emit dataChanged();
+	engine::mixer()->commandQueue().postAndWait( cmd );
 
-	engine::mixer()->unlock();
+	emit dataChanged();
 }
 
 
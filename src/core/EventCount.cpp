@@ -0,0 +1,96 @@
+/*
+ * EventCount.cpp - lets threads sleep until an event happens without lost wake-ups
+ *
+ * Copyright (c) 2014 Tobias Doerffel <tobydox/at/users.sourceforge.net>
+ *
+ * This file is part of Linux MultiMedia Studio - http://lmms.sourceforge.net
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "EventCount.h"
+
+#ifdef LMMS_BUILD_LINUX
+#include <climits>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#endif
+
+
+
+EventCount::EventCount() :
+	m_seq( 0 ),
+	m_waiters( 0 )
+{
+}
+
+
+
+
+int EventCount::prepareWait()
+{
+	m_waiters.fetchAndAddOrdered( 1 );
+	return m_seq;
+}
+
+
+
+
+void EventCount::cancelWait()
+{
+	m_waiters.fetchAndAddOrdered( -1 );
+}
+
+
+
+
+void EventCount::wait( int _key )
+{
+#ifdef LMMS_BUILD_LINUX
+	// returns immediately if m_seq != _key
+	syscall( SYS_futex, &m_seq, FUTEX_WAIT_PRIVATE, _key, NULL, NULL, 0 );
+#else
+	m_mutex.lock();
+	if( m_seq == _key )
+	{
+		m_cond.wait( &m_mutex );
+	}
+	m_mutex.unlock();
+#endif
+	m_waiters.fetchAndAddOrdered( -1 );
+}
+
+
+
+
+void EventCount::notifyAll()
+{
+	__sync_fetch_and_add( &m_seq, 1 );
+	if( m_waiters > 0 )
+	{
+#ifdef LMMS_BUILD_LINUX
+		syscall( SYS_futex, &m_seq, FUTEX_WAKE_PRIVATE, INT_MAX,
+							NULL, NULL, 0 );
+#else
+		m_mutex.lock();
+		m_cond.wakeAll();
+		m_mutex.unlock();
+#endif
+	}
+}
+
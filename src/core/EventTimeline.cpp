@@ -0,0 +1,127 @@
+/*
+ * EventTimeline.cpp - events of a track flattened to song positions
+ *
+ * Copyright (c) 2014 Tobias Doerffel <tobydox/at/users.sourceforge.net>
+ *
+ * This file is part of Linux MultiMedia Studio - http://lmms.sourceforge.net
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <QtCore/QtAlgorithms>
+
+#include "EventTimeline.h"
+#include "templates.h"
+
+
+static bool eventLessThan( const EventTimeline::Event & _e1,
+					const EventTimeline::Event & _e2 )
+{
+	return _e1.pos < _e2.pos;
+}
+
+
+
+
+static tick_t eventPos( const EventTimeline::Event & _e )
+{
+	return _e.pos;
+}
+
+
+
+
+EventTimeline::EventTimeline( int _version ) :
+	m_events(),
+	m_version( _version ),
+	m_cursor( 0 )
+{
+}
+
+
+
+
+void EventTimeline::addEvent( tick_t _pos, trackContentObject * _tco,
+						note * _note, int _index )
+{
+	Event e;
+	e.pos = _pos;
+	e.tco = _tco;
+	e.n = _note;
+	e.index = _index;
+	m_events.push_back( e );
+}
+
+
+
+
+void EventTimeline::finalize()
+{
+	// events at same position keep the order they were added in
+	qStableSort( m_events.begin(), m_events.end(), eventLessThan );
+}
+
+
+
+
+int EventTimeline::firstEventFrom( tick_t _pos ) const
+{
+	return tFirstFrom( m_events, _pos, m_cursor, eventPos );
+}
+
+
+
+
+EventTimelineSlot::EventTimelineSlot() :
+	m_timeline( new EventTimeline ),
+	m_refs( 1 )
+{
+}
+
+
+
+
+EventTimelineSlot::~EventTimelineSlot()
+{
+	delete m_timeline;
+}
+
+
+
+
+void EventTimelineSlot::deref()
+{
+	if( m_refs.fetchAndAddOrdered( -1 ) == 1 )
+	{
+		delete this;
+	}
+}
+
+
+
+
+EventTimeline * EventTimelineSlot::replace( EventTimeline * _timeline )
+{
+	// a command posted earlier might be executed after a newer timeline
+	// has been set directly
+	if( _timeline->version() > m_timeline->version() )
+	{
+		qSwap( m_timeline, _timeline );
+	}
+	return _timeline;
+}
+
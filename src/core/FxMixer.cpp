@@ -28,7 +28,10 @@
 #include <QtXml/QDomElement>
 
 #include "FxMixer.h"
+#include "AudioPort.h"
 #include "Effect.h"
+#include "MicroTimer.h"
+#include "MixHelpers.h"
 #include "song.h"
 
 
@@ -42,10 +45,20 @@ FxChannel::FxChannel( Model * _parent ) :
 	m_muteModel( false, _parent ),
 	m_volumeModel( 1.0, 0.0, 2.0, 0.01, _parent ),
 	m_name(),
-	m_lock()
+	m_traceName( -1 ),
+	m_firstInput( NULL ),
+	m_lastInput( NULL ),
+	m_active( false ),
+	m_renderJob( -1 ),
+	m_renderCost( 0 ),
+	m_profile(),
+	m_inputProfile()
 {
 	engine::mixer()->clearAudioBuffer( m_buffer,
 					engine::mixer()->framesPerPeriod() );
+	engine::mixer()->lock();
+	m_traceName = engine::mixer()->tracer().addName( m_name );
+	engine::mixer()->unlock();
 }
 
 
@@ -53,22 +66,44 @@ FxChannel::FxChannel( Model * _parent ) :
 
 FxChannel::~FxChannel()
 {
+	// mixer is gone already when FX mixer is destroyed on shutdown
+	if( engine::mixer() )
+	{
+		engine::mixer()->lock();
+		engine::mixer()->tracer().removeName( m_traceName );
+		engine::mixer()->unlock();
+	}
 	delete[] m_buffer;
 }
 
 
 
 
+void FxChannel::setName( const QString & _name )
+{
+	engine::mixer()->lock();
+	m_name = _name;
+	engine::mixer()->tracer().setName( m_traceName, m_name );
+	engine::mixer()->unlock();
+}
+
+
+
+
 
 
 FxMixer::FxMixer() :
 	JournallingObject(),
-	Model( NULL )
+	Model( NULL ),
+	m_fxChannels(),
+	m_activeChannels()
 {
 	for( int i = 0; i < NumFxChannels+1; ++i )
 	{
-		m_fxChannels[i] = new FxChannel( this );
+		m_fxChannels.push_back( new FxChannel( this ) );
 	}
+	// never allocate while rendering
+	m_activeChannels.reserve( m_fxChannels.size() );
 	// reset name etc.
 	clear();
 }
@@ -78,7 +113,7 @@ FxMixer::FxMixer() :
 
 FxMixer::~FxMixer()
 {
-	for( int i = 0; i < NumFxChannels+1; ++i )
+	for( int i = 0; i < m_fxChannels.size(); ++i )
 	{
 		delete m_fxChannels[i];
 	}
@@ -91,17 +126,47 @@ void FxMixer::mixToChannel( const sampleFrame * _buf, fx_ch_t _ch )
 {
 	if( m_fxChannels[_ch]->m_muteModel.value() == false )
 	{
-		m_fxChannels[_ch]->m_lock.lock();
-		sampleFrame * buf = m_fxChannels[_ch]->m_buffer;
-		for( f_cnt_t f = 0; f < engine::mixer()->framesPerPeriod();
-									++f )
+		MixHelpers::add( m_fxChannels[_ch]->m_buffer, _buf,
+					engine::mixer()->framesPerPeriod() );
+		m_fxChannels[_ch]->m_used = true;
+	}
+}
+
+
+
+
+void FxMixer::addInput( fx_ch_t _ch, AudioPort * _port )
+{
+	FxChannel * ch = m_fxChannels[_ch];
+	_port->m_nextFxInput = NULL;
+	if( ch->m_lastInput != NULL )
+	{
+		ch->m_lastInput->m_nextFxInput = _port;
+	}
+	else
+	{
+		ch->m_firstInput = _port;
+	}
+	ch->m_lastInput = _port;
+}
+
+
+
+
+void FxMixer::mixInputs( fx_ch_t _ch )
+{
+	FxChannel * ch = m_fxChannels[_ch];
+	for( AudioPort * port = ch->m_firstInput; port != NULL;
+						port = port->m_nextFxInput )
+	{
+		if( port->m_hasOutput )
 		{
-			buf[f][0] += _buf[f][0];
-			buf[f][1] += _buf[f][1];
+			mixToChannel( port->firstBuffer(), _ch );
+			port->m_hasOutput = false;
+			port->nextPeriod();
 		}
-		m_fxChannels[_ch]->m_used = true;
-		m_fxChannels[_ch]->m_lock.unlock();
 	}
+	ch->m_firstInput = ch->m_lastInput = NULL;
 }
 
 
@@ -109,10 +174,11 @@ void FxMixer::mixToChannel( const sampleFrame * _buf, fx_ch_t _ch )
 
 void FxMixer::processChannel( fx_ch_t _ch, sampleFrame * _buf )
 {
+	// a channel without input and without effects having a tail is
+	// silent, so there's nothing to process and no peak to find
 	if( m_fxChannels[_ch]->m_muteModel.value() == false &&
 		( m_fxChannels[_ch]->m_used ||
-				m_fxChannels[_ch]->m_stillRunning ||
-								_ch == 0 ) )
+				m_fxChannels[_ch]->m_stillRunning ) )
 	{
 		if( _buf == NULL )
 		{
@@ -123,8 +189,10 @@ void FxMixer::processChannel( fx_ch_t _ch, sampleFrame * _buf )
 		{
 			m_fxChannels[_ch]->m_fxChain.startRunning();
 			m_fxChannels[_ch]->m_stillRunning = m_fxChannels[_ch]->m_fxChain.processAudioBuffer( _buf, f );
-			float peakLeft = engine::mixer()->peakValueLeft( _buf, f ) * m_fxChannels[_ch]->m_volumeModel.value();
-			float peakRight = engine::mixer()->peakValueRight( _buf, f ) * m_fxChannels[_ch]->m_volumeModel.value();
+			float peakLeft, peakRight;
+			MixHelpers::peakValues( _buf, f, &peakLeft, &peakRight );
+			peakLeft *= m_fxChannels[_ch]->m_volumeModel.value();
+			peakRight *= m_fxChannels[_ch]->m_volumeModel.value();
 
 			if( peakLeft > m_fxChannels[_ch]->m_peakLeft )
 			{
@@ -147,55 +215,107 @@ void FxMixer::processChannel( fx_ch_t _ch, sampleFrame * _buf )
 
 
 
-void FxMixer::prepareMasterMix()
-{
-	engine::mixer()->clearAudioBuffer( m_fxChannels[0]->m_buffer,
-					engine::mixer()->framesPerPeriod() );
-}
-
-
-
-
 void FxMixer::masterMix( sampleFrame * _buf )
 {
 	const int fpp = engine::mixer()->framesPerPeriod();
-	memcpy( _buf, m_fxChannels[0]->m_buffer, sizeof( sampleFrame ) * fpp );
 
-	for( int i = 1; i < NumFxChannels+1; ++i )
+	// buffers of all channels are kept cleared as long as they're not
+	// used, so silent channels can be skipped entirely
+	FxChannel * master = m_fxChannels[0];
+	mixInputs( 0 );
+	bool used = master->m_used;
+	if( used )
 	{
-		if( m_fxChannels[i]->m_used )
+		memcpy( _buf, master->m_buffer, sizeof( sampleFrame ) * fpp );
+		engine::mixer()->clearAudioBuffer( master->m_buffer, fpp );
+	}
+
+	// channels stay active as long as their effects have a tail, the
+	// others are activated again when an audio port is routed to them
+	QVector<fx_ch_t>::Iterator stillActive = m_activeChannels.begin();
+	for( QVector<fx_ch_t>::Iterator it = m_activeChannels.begin();
+					it != m_activeChannels.end(); ++it )
+	{
+		FxChannel * ch = m_fxChannels[*it];
+		if( ch->m_used )
 		{
-			sampleFrame * ch_buf = m_fxChannels[i]->m_buffer;
-			const float v = m_fxChannels[i]->m_volumeModel.value();
-			for( f_cnt_t f = 0; f < fpp; ++f )
+			// follow automation sample-accurately if it changed
+			// volume within this period
+			const float * vol = ch->m_volumeModel.valueBuffer();
+			if( vol )
 			{
-				_buf[f][0] += ch_buf[f][0] * v;
-				_buf[f][1] += ch_buf[f][1] * v;
+				MixHelpers::addMultipliedByBuffer( _buf,
+						ch->m_buffer, vol, fpp );
 			}
-			engine::mixer()->clearAudioBuffer( ch_buf,
-					engine::mixer()->framesPerPeriod() );
-			m_fxChannels[i]->m_used = false;
+			else
+			{
+				MixHelpers::addMultiplied( _buf, ch->m_buffer,
+					ch->m_volumeModel.value(), fpp );
+			}
+			engine::mixer()->clearAudioBuffer( ch->m_buffer, fpp );
+			ch->m_used = false;
+			used = true;
+		}
+		if( ch->m_stillRunning )
+		{
+			*stillActive++ = *it;
+		}
+		else
+		{
+			ch->m_active = false;
 		}
 	}
+	m_activeChannels.erase( stillActive, m_activeChannels.end() );
+
+	master->m_used = used;
 
+	MicroTimer timer;
 	processChannel( 0, _buf );
+	master->m_profile.add( timer.elapsed() );
 
-	if( m_fxChannels[0]->m_muteModel.value() )
+	used = master->m_used;
+	// ports mixing into master channel will set it again
+	master->m_used = false;
+
+	if( master->m_muteModel.value() )
 	{
-		engine::mixer()->clearAudioBuffer( _buf,
-					engine::mixer()->framesPerPeriod() );
+		if( used )
+		{
+			engine::mixer()->clearAudioBuffer( _buf, fpp );
+		}
 		return;
 	}
 
-	const float v = m_fxChannels[0]->m_volumeModel.value();
-	for( f_cnt_t f = 0; f < engine::mixer()->framesPerPeriod(); ++f )
+	if( !used )
 	{
-		_buf[f][0] *= v;
-		_buf[f][1] *= v;
+		// _buf is still silent
+		return;
 	}
 
-	m_fxChannels[0]->m_peakLeft *= engine::mixer()->masterGain();
-	m_fxChannels[0]->m_peakRight *= engine::mixer()->masterGain();
+	const float * vol = master->m_volumeModel.valueBuffer();
+	if( vol )
+	{
+		MixHelpers::multiplyByBuffer( _buf, vol, fpp );
+	}
+	else
+	{
+		MixHelpers::multiply( _buf, master->m_volumeModel.value(), fpp );
+	}
+
+	master->m_peakLeft *= engine::mixer()->masterGain();
+	master->m_peakRight *= engine::mixer()->masterGain();
+}
+
+
+
+
+void FxMixer::activateChannel( fx_ch_t _ch )
+{
+	if( _ch > 0 && _ch <= numChannels() && !m_fxChannels[_ch]->m_active )
+	{
+		m_fxChannels[_ch]->m_active = true;
+		m_activeChannels.push_back( _ch );
+	}
 }
 
 
@@ -203,13 +323,13 @@ void FxMixer::masterMix( sampleFrame * _buf )
 
 void FxMixer::clear()
 {
-	for( int i = 0; i <= NumFxChannels; ++i )
+	for( int i = 0; i < m_fxChannels.size(); ++i )
 	{
 		m_fxChannels[i]->m_fxChain.clear();
 		m_fxChannels[i]->m_volumeModel.setValue( 1.0f );
 		m_fxChannels[i]->m_muteModel.setValue( false );
-		m_fxChannels[i]->m_name = ( i == 0 ) ?
-				tr( "Master" ) : tr( "FX %1" ).arg( i );
+		m_fxChannels[i]->setName( ( i == 0 ) ?
+				tr( "Master" ) : tr( "FX %1" ).arg( i ) );
 		m_fxChannels[i]->m_volumeModel.setDisplayName( 
 				m_fxChannels[i]->m_name );
 
@@ -221,7 +341,7 @@ void FxMixer::clear()
 
 void FxMixer::saveSettings( QDomDocument & _doc, QDomElement & _this )
 {
-	for( int i = 0; i <= NumFxChannels; ++i )
+	for( int i = 0; i < m_fxChannels.size(); ++i )
 	{
 		QDomElement fxch = _doc.createElement( QString( "fxchannel" ) );
 		_this.appendChild( fxch );
@@ -242,16 +362,21 @@ void FxMixer::loadSettings( const QDomElement & _this )
 {
 	clear();
 	QDomNode node = _this.firstChild();
-	for( int i = 0; i <= NumFxChannels; ++i )
+	for( int i = 0; i < m_fxChannels.size(); ++i )
 	{
 		QDomElement fxch = node.toElement();
 		int num = fxch.attribute( "num" ).toInt();
+		if( effectChannel( num ) == NULL )
+		{
+			node = node.nextSibling();
+			continue;
+		}
 		m_fxChannels[num]->m_fxChain.restoreState(
 			fxch.firstChildElement(
 				m_fxChannels[num]->m_fxChain.nodeName() ) );
 		m_fxChannels[num]->m_volumeModel.loadSettings( fxch, "volume" );
 		m_fxChannels[num]->m_muteModel.loadSettings( fxch, "muted" );
-		m_fxChannels[num]->m_name = fxch.attribute( "name" );
+		m_fxChannels[num]->setName( fxch.attribute( "name" ) );
 		node = node.nextSibling();
 	}
 
@@ -160,27 +160,17 @@ void InstrumentSoundShaping::processAudioBuffer( sampleFrame * _ab,
 		}
 		_n->m_filter->setFilterType( m_filterModel.value() );
 
-#ifdef __GNUC__
-		float cut_buf[_frames];
-		float res_buf[_frames];
-#else
-		float * cut_buf = NULL;
-		float * res_buf = NULL;
-#endif
+		// periods never exceed DEFAULT_BUFFER_SIZE frames
+		float cut_buf[DEFAULT_BUFFER_SIZE];
+		float res_buf[DEFAULT_BUFFER_SIZE];
 
 		if( m_envLfoParameters[Cut]->isUsed() )
 		{
-#ifndef __GNUC__
-			cut_buf = new float[_frames];
-#endif
 			m_envLfoParameters[Cut]->fillLevel( cut_buf, total_frames,
 						release_begin, _frames );
 		}
 		if( m_envLfoParameters[Resonance]->isUsed() )
 		{
-#ifndef __GNUC__
-			res_buf = new float[_frames];
-#endif
 			m_envLfoParameters[Resonance]->fillLevel( res_buf,
 						total_frames, release_begin,
 								_frames );
@@ -254,20 +244,11 @@ void InstrumentSoundShaping::processAudioBuffer( sampleFrame * _ab,
 				_ab[frame][1] = _n->m_filter->update( _ab[frame][1], 1 );
 			}
 		}
-
-#ifndef __GNUC__
-		delete[] cut_buf;
-		delete[] res_buf;
-#endif
 	}
 
 	if( m_envLfoParameters[Volume]->isUsed() )
 	{
-#ifdef __GNUC__
-		float vol_buf[_frames];
-#else
-		float * vol_buf = new float[_frames];
-#endif
+		float vol_buf[DEFAULT_BUFFER_SIZE];
 		m_envLfoParameters[Volume]->fillLevel( vol_buf, total_frames,
 						release_begin, _frames );
 
@@ -278,9 +259,6 @@ void InstrumentSoundShaping::processAudioBuffer( sampleFrame * _ab,
 			_ab[frame][0] = vol_level * _ab[frame][0];
 			_ab[frame][1] = vol_level * _ab[frame][1];
 		}
-#ifndef __GNUC__
-		delete[] vol_buf;
-#endif
 	}
 
 /*	else if( m_envLfoParameters[Volume]->isUsed() == false && m_envLfoParameters[PANNING]->isUsed() )
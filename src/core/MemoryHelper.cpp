@@ -0,0 +1,61 @@
+/*
+ * MemoryHelper.cpp - helper functions for allocating aligned memory
+ *
+ * Copyright (c) 2014 Tobias Doerffel <tobydox/at/users.sourceforge.net>
+ *
+ * This file is part of Linux MultiMedia Studio - http://lmms.sourceforge.net
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <cstdlib>
+
+#include "MemoryHelper.h"
+#include "lmms_basics.h"
+
+
+
+void * MemoryHelper::alignedMalloc( int _bytes )
+{
+	char *ptr,*ptr2,*aligned_ptr;
+	int align_mask = ALIGN_SIZE- 1;
+	ptr=(char *)malloc(_bytes +ALIGN_SIZE+ sizeof(int));
+	if(ptr==NULL) return(NULL);
+
+	ptr2 = ptr + sizeof(int);
+	aligned_ptr = ptr2 + (ALIGN_SIZE- ((size_t)ptr2 & align_mask));
+
+
+	ptr2 = aligned_ptr - sizeof(int);
+	*((int *)ptr2)=(int)(aligned_ptr - ptr);
+
+	return(aligned_ptr);
+}
+
+
+
+
+void MemoryHelper::alignedFree( void * _buf )
+{
+	if( _buf != NULL )
+	{
+		int *ptr2=(int *)_buf - 1;
+		_buf = (char *)_buf- *ptr2;
+		free(_buf);
+	}
+}
+
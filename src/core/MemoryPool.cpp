@@ -0,0 +1,209 @@
+/*
+ * MemoryPool.cpp - fixed-capacity lock-free pool for objects allocated while
+ *                  rendering
+ *
+ * Copyright (c) 2014 Tobias Doerffel <tobydox/at/users.sourceforge.net>
+ *
+ * This file is part of Linux MultiMedia Studio - http://lmms.sourceforge.net
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <new>
+
+#include <QtCore/QMutex>
+
+#include "MemoryPool.h"
+#include "MemoryHelper.h"
+#include "RealtimeHelper.h"
+#include "lmms_basics.h"
+
+
+// all pools ever created - never deleted as pools live until program exit
+static QMutex * poolsMutex()
+{
+	static QMutex * s_mutex = new QMutex;
+	return s_mutex;
+}
+
+static QVector<const MemoryPool *> * pools()
+{
+	static QVector<const MemoryPool *> * s_pools =
+					new QVector<const MemoryPool *>;
+	return s_pools;
+}
+
+
+
+
+MemoryPool::MemoryPool( const char * _name, size_t _objectSize,
+							int _capacity ) :
+	m_name( _name ),
+	m_slotSize( ( _objectSize + ALIGN_SIZE - 1 ) & ~( ALIGN_SIZE - 1 ) ),
+	m_capacity( qBound<int>( 1, _capacity, MaxCapacity ) ),
+	m_memory( NULL ),
+	m_next( new int[m_capacity] ),
+	m_head( 0 ),
+	m_used( 0 ),
+	m_peak( 0 ),
+	m_overflows( 0 )
+{
+	m_memory = static_cast<char *>(
+			MemoryHelper::alignedMalloc( m_slotSize * m_capacity ) );
+	// make sure all pages are mapped before render threads start using
+	// the slots
+	RealtimeHelper::prefault( m_memory, m_slotSize * m_capacity );
+
+	for( int i = 0; i < m_capacity-1; ++i )
+	{
+		m_next[i] = i+1;
+	}
+	m_next[m_capacity-1] = NilIndex;
+
+	QMutexLocker lock( poolsMutex() );
+	pools()->push_back( this );
+}
+
+
+
+
+MemoryPool::~MemoryPool()
+{
+	QMutexLocker lock( poolsMutex() );
+	pools()->remove( pools()->indexOf( this ) );
+
+	MemoryHelper::alignedFree( m_memory );
+	delete[] m_next;
+}
+
+
+
+
+void * MemoryPool::allocate( size_t _size )
+{
+	const int index = _size <= m_slotSize ? pop() : NilIndex;
+	if( index == NilIndex )
+	{
+		m_overflows.fetchAndAddOrdered( 1 );
+		return ::operator new( _size );
+	}
+
+	const int used = m_used.fetchAndAddOrdered( 1 ) + 1;
+	int peak = m_peak;
+	while( used > peak && !m_peak.testAndSetOrdered( peak, used ) )
+	{
+		peak = m_peak;
+	}
+
+	return m_memory + index * m_slotSize;
+}
+
+
+
+
+void MemoryPool::deallocate( void * _ptr )
+{
+	char * ptr = static_cast<char *>( _ptr );
+	if( ptr < m_memory || ptr >= m_memory + m_capacity * m_slotSize )
+	{
+		// either NULL or allocated from heap because pool was exhausted
+		::operator delete( _ptr );
+		return;
+	}
+
+	m_used.fetchAndAddOrdered( -1 );
+	push( ( ptr - m_memory ) / m_slotSize );
+}
+
+
+
+
+MemoryPool::Statistics MemoryPool::statistics() const
+{
+	Statistics s;
+	s.name = m_name;
+	s.capacity = m_capacity;
+	s.used = m_used;
+	s.peak = m_peak;
+	s.overflows = m_overflows;
+	return s;
+}
+
+
+
+
+MemoryPool::StatisticsList MemoryPool::allStatistics()
+{
+	QMutexLocker lock( poolsMutex() );
+
+	StatisticsList list;
+	for( QVector<const MemoryPool *>::ConstIterator it = pools()->begin();
+						it != pools()->end(); ++it )
+	{
+		list.push_back( ( *it )->statistics() );
+	}
+	return list;
+}
+
+
+
+
+int MemoryPool::pop()
+{
+	while( true )
+	{
+		const int head = m_head;
+		const int index = head & IndexMask;
+		if( index == NilIndex )
+		{
+			return NilIndex;
+		}
+		// m_next[index] might be stale if another thread popped the
+		// slot meanwhile - the tag makes the CAS fail in that case
+		const int newHead = nextTag( head ) | m_next[index];
+		if( m_head.testAndSetOrdered( head, newHead ) )
+		{
+			return index;
+		}
+	}
+}
+
+
+
+
+void MemoryPool::push( int _index )
+{
+	while( true )
+	{
+		const int head = m_head;
+		m_next[_index] = head & IndexMask;
+		if( m_head.testAndSetOrdered( head, nextTag( head ) | _index ) )
+		{
+			return;
+		}
+	}
+}
+
+
+
+
+int MemoryPool::nextTag( int _head )
+{
+	return static_cast<int>( ( static_cast<unsigned int>( _head ) +
+					( 1u << IndexBits ) ) & ~IndexMask );
+}
+
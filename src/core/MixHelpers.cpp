@@ -22,21 +22,18 @@
  *
  */
 
+#include <QtCore/QtGlobal>
+
 #include "MixHelpers.h"
+#include "MixHelpersKernels.h"
 
+#if defined(LMMS_HOST_X86) || defined(LMMS_HOST_X86_64)
+#include <cpuid.h>
+#endif
 
-namespace MixHelpers
-{
 
-/*! \brief Function for applying MIXOP on all sample frames */
-template<typename MIXOP>
-static inline void run( sampleFrame* dst, const sampleFrame* src, int frames, const MIXOP& OP )
+namespace MixHelpers
 {
-	for( int i = 0; i < frames; ++i )
-	{
-		OP( dst[i], src[i] );
-	}
-}
 
 /*! \brief Function for applying MIXOP on all sample frames - split source */
 template<typename MIXOP>
@@ -51,92 +48,222 @@ static inline void run( sampleFrame* dst, const sample_t* srcLeft, const sample_
 
 
 
-struct AddOp
+struct MultiplyAndAddMultipliedOp
 {
+	MultiplyAndAddMultipliedOp( float coeffDst, float coeffSrc )
+	{
+		m_coeffs[0] = coeffDst;
+		m_coeffs[1] = coeffSrc;
+	}
+
 	void operator()( sampleFrame& dst, const sampleFrame& src ) const
 	{
-		dst[0] += src[0];
-		dst[1] += src[1];
+		dst[0] = dst[0]*m_coeffs[0] + src[0]*m_coeffs[1];
+		dst[1] = dst[1]*m_coeffs[0] + src[1]*m_coeffs[1];
 	}
+
+	float m_coeffs[2];
 } ;
 
-void add( sampleFrame* dst, const sampleFrame* src, int frames )
+
+
+// plain C++ kernels working on one sample at a time - used on CPUs without
+// supported SIMD extensions and for remaining samples by SIMD kernels
+
+static void genericAdd( sample_t* dst, const sample_t* src, int samples )
 {
-	run<>( dst, src, frames, AddOp() );
+	for( int i = 0; i < samples; ++i )
+	{
+		dst[i] += src[i];
+	}
 }
 
 
 
-struct AddMultipliedOp
+static void genericAddMultiplied( sample_t* dst, const sample_t* src, float coeff, int samples )
 {
-	AddMultipliedOp( float coeff ) : m_coeff( coeff ) { }
+	for( int i = 0; i < samples; ++i )
+	{
+		dst[i] += src[i] * coeff;
+	}
+}
 
-	void operator()( sampleFrame& dst, const sampleFrame& src ) const
+
+
+static void genericAddMultipliedStereo( sample_t* dst, const sample_t* src, float coeffLeft, float coeffRight, int samples )
+{
+	for( int i = 0; i < samples; i += 2 )
 	{
-		dst[0] += src[0] * m_coeff;
-		dst[1] += src[1] * m_coeff;
+		dst[i+0] += src[i+0] * coeffLeft;
+		dst[i+1] += src[i+1] * coeffRight;
 	}
+}
 
-	const float m_coeff;
-} ;
 
 
-void addMultiplied( sampleFrame* dst, const sampleFrame* src, float coeffSrc, int frames )
+static void genericMultiplyAndAddMultiplied( sample_t* dst, const sample_t* src, float coeffDst, float coeffSrc, int samples )
 {
-	run<>( dst, src, frames, AddMultipliedOp(coeffSrc) );
+	for( int i = 0; i < samples; ++i )
+	{
+		dst[i] = dst[i]*coeffDst + src[i]*coeffSrc;
+	}
 }
 
 
 
-struct AddMultipliedStereoOp
+static void genericMultiply( sample_t* dst, float coeff, int samples )
 {
-	AddMultipliedStereoOp( float coeffLeft, float coeffRight )
+	for( int i = 0; i < samples; ++i )
 	{
-		m_coeffs[0] = coeffLeft;
-		m_coeffs[1] = coeffRight;
+		dst[i] *= coeff;
 	}
+}
 
-	void operator()( sampleFrame& dst, const sampleFrame& src ) const
+
+
+static void genericPeakValues( const sample_t* src, int samples, float* peakLeft, float* peakRight )
+{
+	float l = 0.0f;
+	float r = 0.0f;
+	for( int i = 0; i < samples; i += 2 )
 	{
-		dst[0] += src[0] * m_coeffs[0];
-		dst[1] += src[1] * m_coeffs[1];
+		l = qMax( l, qAbs( src[i+0] ) );
+		r = qMax( r, qAbs( src[i+1] ) );
 	}
+	*peakLeft = l;
+	*peakRight = r;
+}
 
-	float m_coeffs[2];
-} ;
 
 
-void addMultipliedStereo( sampleFrame* dst, const sampleFrame* src, float coeffSrcLeft, float coeffSrcRight, int frames )
+static void genericConvertToS16( const sample_t* src, int samples, float gain, int_sample_t* dst )
 {
+	for( int i = 0; i < samples; ++i )
+	{
+		dst[i] = static_cast<int_sample_t>(
+				qBound( -1.0f, src[i] * gain, 1.0f ) * 32767.0f );
+	}
+}
+
 
-	run<>( dst, src, frames, AddMultipliedStereoOp(coeffSrcLeft, coeffSrcRight) );
+
+static void genericDeinterleave( const sample_t* src, int frames, sample_t* left, sample_t* right )
+{
+	for( int f = 0; f < frames; ++f )
+	{
+		left[f] = src[f*2+0];
+		right[f] = src[f*2+1];
+	}
 }
 
 
 
+static void genericInterleave( const sample_t* left, const sample_t* right, int frames, sample_t* dst )
+{
+	for( int f = 0; f < frames; ++f )
+	{
+		dst[f*2+0] = left[f];
+		dst[f*2+1] = right[f];
+	}
+}
 
 
-struct MultiplyAndAddMultipliedOp
+
+const Kernels genericKernels =
 {
-	MultiplyAndAddMultipliedOp( float coeffDst, float coeffSrc )
+	"generic",
+	genericAdd,
+	genericAddMultiplied,
+	genericAddMultipliedStereo,
+	genericMultiplyAndAddMultiplied,
+	genericMultiply,
+	genericPeakValues,
+	genericConvertToS16,
+	genericDeinterleave,
+	genericInterleave
+} ;
+
+
+
+#if defined(LMMS_HOST_X86) || defined(LMMS_HOST_X86_64)
+static bool cpuHasSSE2()
+{
+	unsigned int eax, ebx, ecx, edx;
+	return __get_cpuid( 1, &eax, &ebx, &ecx, &edx ) && ( edx & bit_SSE2 );
+}
+
+
+
+static bool cpuHasAVX()
+{
+	unsigned int eax, ebx, ecx, edx;
+	if( !__get_cpuid( 1, &eax, &ebx, &ecx, &edx ) ||
+		!( ecx & bit_OSXSAVE ) || !( ecx & bit_AVX ) )
 	{
-		m_coeffs[0] = coeffDst;
-		m_coeffs[1] = coeffSrc;
+		return false;
 	}
+	// check whether OS saves YMM registers on context switch (xgetbv
+	// written as bytes for the sake of old assemblers)
+	unsigned int xcr0Low, xcr0High;
+	__asm__ __volatile__( ".byte 0x0f, 0x01, 0xd0" :
+				"=a" ( xcr0Low ), "=d" ( xcr0High ) : "c" ( 0 ) );
+	return ( xcr0Low & 6 ) == 6;
+}
+#endif
 
-	void operator()( sampleFrame& dst, const sampleFrame& src ) const
+
+
+static const Kernels* selectKernels()
+{
+#if defined(LMMS_HOST_X86) || defined(LMMS_HOST_X86_64)
+	if( cpuHasAVX() )
 	{
-		dst[0] = dst[0]*m_coeffs[0] + src[0]*m_coeffs[1];
-		dst[1] = dst[1]*m_coeffs[0] + src[1]*m_coeffs[1];
+		return &avxKernels;
+	}
+	if( cpuHasSSE2() )
+	{
+		return &sse2Kernels;
 	}
+#endif
+	return &genericKernels;
+}
+
+
+static const Kernels* s_kernels = selectKernels();
+
+
+
+const char* instructionSet()
+{
+	return s_kernels->name;
+}
+
+
+
+void add( sampleFrame* dst, const sampleFrame* src, int frames )
+{
+	s_kernels->add( dst[0], src[0], frames * DEFAULT_CHANNELS );
+}
+
+
+
+void addMultiplied( sampleFrame* dst, const sampleFrame* src, float coeffSrc, int frames )
+{
+	s_kernels->addMultiplied( dst[0], src[0], coeffSrc, frames * DEFAULT_CHANNELS );
+}
+
+
+
+void addMultipliedStereo( sampleFrame* dst, const sampleFrame* src, float coeffSrcLeft, float coeffSrcRight, int frames )
+{
+	s_kernels->addMultipliedStereo( dst[0], src[0], coeffSrcLeft, coeffSrcRight, frames * DEFAULT_CHANNELS );
+}
 
-	float m_coeffs[2];
-} ;
 
 
 void multiplyAndAddMultiplied( sampleFrame* dst, const sampleFrame* src, float coeffDst, float coeffSrc, int frames )
 {
-	run<>( dst, src, frames, MultiplyAndAddMultipliedOp(coeffDst, coeffSrc) );
+	s_kernels->multiplyAndAddMultiplied( dst[0], src[0], coeffDst, coeffSrc, frames * DEFAULT_CHANNELS );
 }
 
 
@@ -149,5 +276,62 @@ void multiplyAndAddMultipliedJoined( sampleFrame* dst,
 	run<>( dst, srcLeft, srcRight, frames, MultiplyAndAddMultipliedOp(coeffDst, coeffSrc) );
 }
 
+
+
+void multiply( sampleFrame* dst, float coeff, int frames )
+{
+	s_kernels->multiply( dst[0], coeff, frames * DEFAULT_CHANNELS );
+}
+
+
+
+void multiplyByBuffer( sampleFrame* dst, const float* coeffs, int frames )
+{
+	for( int f = 0; f < frames; ++f )
+	{
+		dst[f][0] *= coeffs[f];
+		dst[f][1] *= coeffs[f];
+	}
 }
 
+
+
+void addMultipliedByBuffer( sampleFrame* dst, const sampleFrame* src, const float* coeffsSrc, int frames )
+{
+	for( int f = 0; f < frames; ++f )
+	{
+		dst[f][0] += src[f][0] * coeffsSrc[f];
+		dst[f][1] += src[f][1] * coeffsSrc[f];
+	}
+}
+
+
+
+void peakValues( const sampleFrame* src, int frames, float* peakLeft, float* peakRight )
+{
+	s_kernels->peakValues( src[0], frames * DEFAULT_CHANNELS, peakLeft, peakRight );
+}
+
+
+
+void convertToS16( const sample_t* src, int samples, float gain, int_sample_t* dst )
+{
+	s_kernels->convertToS16( src, samples, gain, dst );
+}
+
+
+
+
+void deinterleave( const sampleFrame* src, int frames, sample_t* left, sample_t* right )
+{
+	s_kernels->deinterleave( src[0], frames, left, right );
+}
+
+
+
+void interleave( const sample_t* left, const sample_t* right, int frames, sampleFrame* dst )
+{
+	s_kernels->interleave( left, right, frames, dst[0] );
+}
+
+}
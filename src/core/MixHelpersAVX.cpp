@@ -0,0 +1,222 @@
+/*
+ * MixHelpersAVX.cpp - mixing functions using AVX instructions
+ *
+ * Copyright (c) 2014 Tobias Doerffel <tobydox/at/users.sourceforge.net>
+ *
+ * This file is part of Linux MultiMedia Studio - http://lmms.sourceforge.net
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "MixHelpersKernels.h"
+
+#if defined(LMMS_HOST_X86) || defined(LMMS_HOST_X86_64)
+
+#include <immintrin.h>
+
+
+namespace MixHelpers
+{
+
+// all loads and stores are unaligned as buffers are not guaranteed to be
+// aligned to 32 bytes
+
+static void avxAdd( sample_t* dst, const sample_t* src, int samples )
+{
+	int i = 0;
+	for( ; i + 8 <= samples; i += 8 )
+	{
+		_mm256_storeu_ps( dst+i, _mm256_add_ps( _mm256_loadu_ps( dst+i ),
+						_mm256_loadu_ps( src+i ) ) );
+	}
+	genericKernels.add( dst+i, src+i, samples-i );
+}
+
+
+
+static void avxAddMultiplied( sample_t* dst, const sample_t* src, float coeff, int samples )
+{
+	const __m256 c = _mm256_set1_ps( coeff );
+	int i = 0;
+	for( ; i + 8 <= samples; i += 8 )
+	{
+		_mm256_storeu_ps( dst+i, _mm256_add_ps( _mm256_loadu_ps( dst+i ),
+				_mm256_mul_ps( _mm256_loadu_ps( src+i ), c ) ) );
+	}
+	genericKernels.addMultiplied( dst+i, src+i, coeff, samples-i );
+}
+
+
+
+static void avxAddMultipliedStereo( sample_t* dst, const sample_t* src, float coeffLeft, float coeffRight, int samples )
+{
+	const __m256 c = _mm256_setr_ps( coeffLeft, coeffRight,
+						coeffLeft, coeffRight,
+						coeffLeft, coeffRight,
+						coeffLeft, coeffRight );
+	int i = 0;
+	for( ; i + 8 <= samples; i += 8 )
+	{
+		_mm256_storeu_ps( dst+i, _mm256_add_ps( _mm256_loadu_ps( dst+i ),
+				_mm256_mul_ps( _mm256_loadu_ps( src+i ), c ) ) );
+	}
+	genericKernels.addMultipliedStereo( dst+i, src+i, coeffLeft, coeffRight, samples-i );
+}
+
+
+
+static void avxMultiplyAndAddMultiplied( sample_t* dst, const sample_t* src, float coeffDst, float coeffSrc, int samples )
+{
+	const __m256 cd = _mm256_set1_ps( coeffDst );
+	const __m256 cs = _mm256_set1_ps( coeffSrc );
+	int i = 0;
+	for( ; i + 8 <= samples; i += 8 )
+	{
+		_mm256_storeu_ps( dst+i, _mm256_add_ps(
+				_mm256_mul_ps( _mm256_loadu_ps( dst+i ), cd ),
+				_mm256_mul_ps( _mm256_loadu_ps( src+i ), cs ) ) );
+	}
+	genericKernels.multiplyAndAddMultiplied( dst+i, src+i, coeffDst, coeffSrc, samples-i );
+}
+
+
+
+static void avxMultiply( sample_t* dst, float coeff, int samples )
+{
+	const __m256 c = _mm256_set1_ps( coeff );
+	int i = 0;
+	for( ; i + 8 <= samples; i += 8 )
+	{
+		_mm256_storeu_ps( dst+i, _mm256_mul_ps( _mm256_loadu_ps( dst+i ), c ) );
+	}
+	genericKernels.multiply( dst+i, coeff, samples-i );
+}
+
+
+
+static void avxPeakValues( const sample_t* src, int samples, float* peakLeft, float* peakRight )
+{
+	// clearing sign bit yields absolute value
+	const __m256 absMask = _mm256_castsi256_ps( _mm256_set1_epi32( 0x7fffffff ) );
+	// lanes alternately hold left and right
+	__m256 peak = _mm256_setzero_ps();
+	int i = 0;
+	for( ; i + 8 <= samples; i += 8 )
+	{
+		peak = _mm256_max_ps( peak,
+				_mm256_and_ps( _mm256_loadu_ps( src+i ), absMask ) );
+	}
+	genericKernels.peakValues( src+i, samples-i, peakLeft, peakRight );
+
+	// reduce to left and right in lanes 0 and 1 - don't use qMax() here,
+	// a non-inlined instance compiled with AVX could be picked by the
+	// linker for other translation units
+	__m128 p = _mm_max_ps( _mm256_castps256_ps128( peak ),
+					_mm256_extractf128_ps( peak, 1 ) );
+	p = _mm_max_ps( p, _mm_movehl_ps( p, p ) );
+	p = _mm_max_ps( p, _mm_setr_ps( *peakLeft, *peakRight, 0, 0 ) );
+	float lanes[4];
+	_mm_storeu_ps( lanes, p );
+	*peakLeft = lanes[0];
+	*peakRight = lanes[1];
+}
+
+
+
+static void avxConvertToS16( const sample_t* src, int samples, float gain, int_sample_t* dst )
+{
+	const __m256 g = _mm256_set1_ps( gain );
+	const __m256 lo = _mm256_set1_ps( -1.0f );
+	const __m256 hi = _mm256_set1_ps( 1.0f );
+	const __m256 scale = _mm256_set1_ps( 32767.0f );
+	int i = 0;
+	for( ; i + 8 <= samples; i += 8 )
+	{
+		const __m256 a = _mm256_mul_ps( _mm256_min_ps( _mm256_max_ps(
+			_mm256_mul_ps( _mm256_loadu_ps( src+i ), g ), lo ), hi ),
+									scale );
+		// truncate like a cast does - packing 256 bit integer vectors
+		// requires AVX2, so pack both halves with SSE2 instructions
+		const __m256i v = _mm256_cvttps_epi32( a );
+		_mm_storeu_si128( (__m128i *)( dst+i ),
+			_mm_packs_epi32( _mm256_castsi256_si128( v ),
+					_mm256_extractf128_si256( v, 1 ) ) );
+	}
+	genericKernels.convertToS16( src+i, samples-i, gain, dst+i );
+}
+
+
+
+static void avxDeinterleave( const sample_t* src, int frames, sample_t* left, sample_t* right )
+{
+	int f = 0;
+	for( ; f + 8 <= frames; f += 8 )
+	{
+		const __m256 a = _mm256_loadu_ps( src+f*2 );
+		const __m256 b = _mm256_loadu_ps( src+f*2+8 );
+		// frames 0, 1, 4, 5 and 2, 3, 6, 7 - shuffles only work
+		// within 128 bit lanes
+		const __m256 lo = _mm256_permute2f128_ps( a, b, 0x20 );
+		const __m256 hi = _mm256_permute2f128_ps( a, b, 0x31 );
+		_mm256_storeu_ps( left+f, _mm256_shuffle_ps( lo, hi,
+						_MM_SHUFFLE( 2, 0, 2, 0 ) ) );
+		_mm256_storeu_ps( right+f, _mm256_shuffle_ps( lo, hi,
+						_MM_SHUFFLE( 3, 1, 3, 1 ) ) );
+	}
+	genericKernels.deinterleave( src+f*2, frames-f, left+f, right+f );
+}
+
+
+
+static void avxInterleave( const sample_t* left, const sample_t* right, int frames, sample_t* dst )
+{
+	int f = 0;
+	for( ; f + 8 <= frames; f += 8 )
+	{
+		const __m256 l = _mm256_loadu_ps( left+f );
+		const __m256 r = _mm256_loadu_ps( right+f );
+		// frames 0, 1, 4, 5 and 2, 3, 6, 7
+		const __m256 lo = _mm256_unpacklo_ps( l, r );
+		const __m256 hi = _mm256_unpackhi_ps( l, r );
+		_mm256_storeu_ps( dst+f*2,
+				_mm256_permute2f128_ps( lo, hi, 0x20 ) );
+		_mm256_storeu_ps( dst+f*2+8,
+				_mm256_permute2f128_ps( lo, hi, 0x31 ) );
+	}
+	genericKernels.interleave( left+f, right+f, frames-f, dst+f*2 );
+}
+
+
+
+const Kernels avxKernels =
+{
+	"AVX",
+	avxAdd,
+	avxAddMultiplied,
+	avxAddMultipliedStereo,
+	avxMultiplyAndAddMultiplied,
+	avxMultiply,
+	avxPeakValues,
+	avxConvertToS16,
+	avxDeinterleave,
+	avxInterleave
+} ;
+
+}
+
+#endif
+
@@ -0,0 +1,210 @@
+/*
+ * MixHelpersSSE2.cpp - mixing functions using SSE2 instructions
+ *
+ * Copyright (c) 2014 Tobias Doerffel <tobydox/at/users.sourceforge.net>
+ *
+ * This file is part of Linux MultiMedia Studio - http://lmms.sourceforge.net
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include "MixHelpersKernels.h"
+
+#if defined(LMMS_HOST_X86) || defined(LMMS_HOST_X86_64)
+
+#include <emmintrin.h>
+
+
+namespace MixHelpers
+{
+
+// all loads and stores are unaligned as buffers are not guaranteed to be
+// aligned to 16 bytes
+
+static void sse2Add( sample_t* dst, const sample_t* src, int samples )
+{
+	int i = 0;
+	for( ; i + 4 <= samples; i += 4 )
+	{
+		_mm_storeu_ps( dst+i, _mm_add_ps( _mm_loadu_ps( dst+i ),
+						_mm_loadu_ps( src+i ) ) );
+	}
+	genericKernels.add( dst+i, src+i, samples-i );
+}
+
+
+
+static void sse2AddMultiplied( sample_t* dst, const sample_t* src, float coeff, int samples )
+{
+	const __m128 c = _mm_set1_ps( coeff );
+	int i = 0;
+	for( ; i + 4 <= samples; i += 4 )
+	{
+		_mm_storeu_ps( dst+i, _mm_add_ps( _mm_loadu_ps( dst+i ),
+				_mm_mul_ps( _mm_loadu_ps( src+i ), c ) ) );
+	}
+	genericKernels.addMultiplied( dst+i, src+i, coeff, samples-i );
+}
+
+
+
+static void sse2AddMultipliedStereo( sample_t* dst, const sample_t* src, float coeffLeft, float coeffRight, int samples )
+{
+	const __m128 c = _mm_setr_ps( coeffLeft, coeffRight,
+						coeffLeft, coeffRight );
+	int i = 0;
+	for( ; i + 4 <= samples; i += 4 )
+	{
+		_mm_storeu_ps( dst+i, _mm_add_ps( _mm_loadu_ps( dst+i ),
+				_mm_mul_ps( _mm_loadu_ps( src+i ), c ) ) );
+	}
+	genericKernels.addMultipliedStereo( dst+i, src+i, coeffLeft, coeffRight, samples-i );
+}
+
+
+
+static void sse2MultiplyAndAddMultiplied( sample_t* dst, const sample_t* src, float coeffDst, float coeffSrc, int samples )
+{
+	const __m128 cd = _mm_set1_ps( coeffDst );
+	const __m128 cs = _mm_set1_ps( coeffSrc );
+	int i = 0;
+	for( ; i + 4 <= samples; i += 4 )
+	{
+		_mm_storeu_ps( dst+i, _mm_add_ps(
+				_mm_mul_ps( _mm_loadu_ps( dst+i ), cd ),
+				_mm_mul_ps( _mm_loadu_ps( src+i ), cs ) ) );
+	}
+	genericKernels.multiplyAndAddMultiplied( dst+i, src+i, coeffDst, coeffSrc, samples-i );
+}
+
+
+
+static void sse2Multiply( sample_t* dst, float coeff, int samples )
+{
+	const __m128 c = _mm_set1_ps( coeff );
+	int i = 0;
+	for( ; i + 4 <= samples; i += 4 )
+	{
+		_mm_storeu_ps( dst+i, _mm_mul_ps( _mm_loadu_ps( dst+i ), c ) );
+	}
+	genericKernels.multiply( dst+i, coeff, samples-i );
+}
+
+
+
+static void sse2PeakValues( const sample_t* src, int samples, float* peakLeft, float* peakRight )
+{
+	// clearing sign bit yields absolute value
+	const __m128 absMask = _mm_castsi128_ps( _mm_set1_epi32( 0x7fffffff ) );
+	// lanes hold left, right, left, right
+	__m128 peak = _mm_setzero_ps();
+	int i = 0;
+	for( ; i + 4 <= samples; i += 4 )
+	{
+		peak = _mm_max_ps( peak,
+				_mm_and_ps( _mm_loadu_ps( src+i ), absMask ) );
+	}
+	genericKernels.peakValues( src+i, samples-i, peakLeft, peakRight );
+
+	// reduce to left and right in lanes 0 and 1 - don't use qMax() here,
+	// a non-inlined instance compiled with SSE2 could be picked by the
+	// linker for other translation units
+	peak = _mm_max_ps( peak, _mm_movehl_ps( peak, peak ) );
+	peak = _mm_max_ps( peak, _mm_setr_ps( *peakLeft, *peakRight, 0, 0 ) );
+	float lanes[4];
+	_mm_storeu_ps( lanes, peak );
+	*peakLeft = lanes[0];
+	*peakRight = lanes[1];
+}
+
+
+
+static void sse2ConvertToS16( const sample_t* src, int samples, float gain, int_sample_t* dst )
+{
+	const __m128 g = _mm_set1_ps( gain );
+	const __m128 lo = _mm_set1_ps( -1.0f );
+	const __m128 hi = _mm_set1_ps( 1.0f );
+	const __m128 scale = _mm_set1_ps( 32767.0f );
+	int i = 0;
+	for( ; i + 8 <= samples; i += 8 )
+	{
+		const __m128 a = _mm_mul_ps( _mm_min_ps( _mm_max_ps(
+				_mm_mul_ps( _mm_loadu_ps( src+i ), g ), lo ), hi ),
+									scale );
+		const __m128 b = _mm_mul_ps( _mm_min_ps( _mm_max_ps(
+				_mm_mul_ps( _mm_loadu_ps( src+i+4 ), g ), lo ), hi ),
+									scale );
+		// truncate like a cast does
+		_mm_storeu_si128( (__m128i *)( dst+i ),
+			_mm_packs_epi32( _mm_cvttps_epi32( a ),
+						_mm_cvttps_epi32( b ) ) );
+	}
+	genericKernels.convertToS16( src+i, samples-i, gain, dst+i );
+}
+
+
+
+static void sse2Deinterleave( const sample_t* src, int frames, sample_t* left, sample_t* right )
+{
+	int f = 0;
+	for( ; f + 4 <= frames; f += 4 )
+	{
+		const __m128 a = _mm_loadu_ps( src+f*2 );
+		const __m128 b = _mm_loadu_ps( src+f*2+4 );
+		_mm_storeu_ps( left+f, _mm_shuffle_ps( a, b,
+						_MM_SHUFFLE( 2, 0, 2, 0 ) ) );
+		_mm_storeu_ps( right+f, _mm_shuffle_ps( a, b,
+						_MM_SHUFFLE( 3, 1, 3, 1 ) ) );
+	}
+	genericKernels.deinterleave( src+f*2, frames-f, left+f, right+f );
+}
+
+
+
+static void sse2Interleave( const sample_t* left, const sample_t* right, int frames, sample_t* dst )
+{
+	int f = 0;
+	for( ; f + 4 <= frames; f += 4 )
+	{
+		const __m128 l = _mm_loadu_ps( left+f );
+		const __m128 r = _mm_loadu_ps( right+f );
+		_mm_storeu_ps( dst+f*2, _mm_unpacklo_ps( l, r ) );
+		_mm_storeu_ps( dst+f*2+4, _mm_unpackhi_ps( l, r ) );
+	}
+	genericKernels.interleave( left+f, right+f, frames-f, dst+f*2 );
+}
+
+
+
+const Kernels sse2Kernels =
+{
+	"SSE2",
+	sse2Add,
+	sse2AddMultiplied,
+	sse2AddMultipliedStereo,
+	sse2MultiplyAndAddMultiplied,
+	sse2Multiply,
+	sse2PeakValues,
+	sse2ConvertToS16,
+	sse2Deinterleave,
+	sse2Interleave
+} ;
+
+}
+
+#endif
+
@@ -39,7 +39,14 @@
 #include "SamplePlayHandle.h"
 #include "piano_roll.h"
 #include "MicroTimer.h"
-#include "atomic_int.h"
+#include "MemoryHelper.h"
+#include "MixerWorkerThread.h"
+#include "RealtimeHelper.h"
+#include "AllocationTracker.h"
+#include "RealtimeLog.h"
+#include "AudioPort.h"
+#include "AutomatableModel.h"
+#include "SampleBuffer.h"
 
 // platform-specific audio-interface-classes
 #include "AudioAlsa.h"
@@ -58,244 +65,6 @@
 #include "MidiDummy.h"
 
 
-static QVector<fx_ch_t> __fx_channel_jobs( NumFxChannels );
-
-
-
-static void aligned_free( void * _buf )
-{
-	if( _buf != NULL )
-	{
-		int *ptr2=(int *)_buf - 1;
-		_buf = (char *)_buf- *ptr2;
-		free(_buf);
-	}
-}
-
-static void * aligned_malloc( int _bytes )
-{
-	char *ptr,*ptr2,*aligned_ptr;
-	int align_mask = ALIGN_SIZE- 1;
-	ptr=(char *)malloc(_bytes +ALIGN_SIZE+ sizeof(int));
-	if(ptr==NULL) return(NULL);
-
-	ptr2 = ptr + sizeof(int);
-	aligned_ptr = ptr2 + (ALIGN_SIZE- ((size_t)ptr2 & align_mask));
-
-
-	ptr2 = aligned_ptr - sizeof(int);
-	*((int *)ptr2)=(int)(aligned_ptr - ptr);
-
-	return(aligned_ptr);
-}
-
-
-
-class MixerWorkerThread : public QThread
-{
-public:
-	enum JobTypes
-	{
-		InvalidJob,
-		PlayHandle,
-		AudioPortEffects,
-		EffectChannel,
-		NumJobTypes
-	} ;
-
-	struct JobQueueItem
-	{
-		JobQueueItem() :
-			type( InvalidJob ),
-			job( NULL ),
-			param( 0 ),
-			done( false )
-		{
-		}
-		JobQueueItem( JobTypes _type, void * _job, int _param = 0 ) :
-			type( _type ),
-			job( _job ),
-			param( _param ),
-			done( false )
-		{
-		}
-
-		JobTypes type;
-		void * job;
-		int param;
-
-		AtomicInt done;
-	} ;
-
-
-	struct JobQueue
-	{
-#define JOB_QUEUE_SIZE 1024
-		JobQueue() :
-			queueSize( 0 )
-		{
-		}
-
-		JobQueueItem items[JOB_QUEUE_SIZE];
-		int queueSize;
-		AtomicInt itemsDone;
-	} ;
-
-	static JobQueue s_jobQueue;
-
-	MixerWorkerThread( int _worker_num, Mixer* mixer ) :
-		QThread( mixer ),
-		m_workingBuf( (sampleFrame *) aligned_malloc(
-					mixer->framesPerPeriod() *
-						sizeof( sampleFrame ) ) ),
-		m_workerNum( _worker_num ),
-		m_quit( false ),
-		m_mixer( mixer ),
-		m_queueReadyWaitCond( &m_mixer->m_queueReadyWaitCond )
-	{
-	}
-
-	virtual ~MixerWorkerThread()
-	{
-		aligned_free( m_workingBuf );
-	}
-
-	virtual void quit()
-	{
-		m_quit = true;
-	}
-
-	void processJobQueue();
-
-
-private:
-	virtual void run()
-	{
-#if 0
-#ifdef LMMS_BUILD_LINUX
-#ifdef LMMS_HAVE_SCHED_H
-		cpu_set_t mask;
-		CPU_ZERO( &mask );
-		CPU_SET( m_workerNum, &mask );
-		sched_setaffinity( 0, sizeof( mask ), &mask );
-#endif
-#endif
-#endif
-		QMutex m;
-		while( m_quit == false )
-		{
-			m.lock();
-			m_queueReadyWaitCond->wait( &m );
-			processJobQueue();
-			m.unlock();
-		}
-	}
-
-	sampleFrame * m_workingBuf;
-	int m_workerNum;
-	volatile bool m_quit;
-	Mixer* m_mixer;
-	QWaitCondition * m_queueReadyWaitCond;
-
-} ;
-
-
-MixerWorkerThread::JobQueue MixerWorkerThread::s_jobQueue;
-
-
-
-void MixerWorkerThread::processJobQueue()
-{
-	for( int i = 0; i < s_jobQueue.queueSize; ++i )
-	{
-		JobQueueItem * it = &s_jobQueue.items[i];
-		if( it->done.fetchAndStoreOrdered( 1 ) == 0 )
-		{
-			switch( it->type )
-			{
-				case PlayHandle:
-					( (playHandle *) it->job )->
-							play( m_workingBuf );
-					break;
-				case AudioPortEffects:
-					{
-	AudioPort * a = (AudioPort *) it->job;
-	const bool me = a->processEffects();
-	if( me || a->m_bufferUsage != AudioPort::NoUsage )
-	{
-		engine::fxMixer()->mixToChannel( a->firstBuffer(),
-							a->nextFxChannel() );
-		a->nextPeriod();
-	}
-					}
-					break;
-				case EffectChannel:
-	engine::fxMixer()->processChannel( (fx_ch_t) it->param );
-					break;
-				default:
-					break;
-			}
-			s_jobQueue.itemsDone.fetchAndAddOrdered( 1 );
-		}
-	}
-}
-
-#define FILL_JOB_QUEUE_BEGIN(_vec_type,_vec,_condition)			\
-	MixerWorkerThread::s_jobQueue.queueSize = 0;			\
-	MixerWorkerThread::s_jobQueue.itemsDone = 0;			\
-	for( _vec_type::Iterator it = _vec.begin();			\
-					it != _vec.end(); ++it )	\
-	{								\
-		if( _condition )					\
-		{
-
-#define FILL_JOB_QUEUE_END()						\
-			++MixerWorkerThread::s_jobQueue.queueSize;	\
-		}							\
-	}
-
-#define FILL_JOB_QUEUE(_vec_type,_vec,_job_type,_condition)		\
-	FILL_JOB_QUEUE_BEGIN(_vec_type,_vec,_condition)			\
-	MixerWorkerThread::s_jobQueue.items				\
-		[MixerWorkerThread::s_jobQueue.queueSize] =		\
-			MixerWorkerThread::JobQueueItem( _job_type,	\
-							(void *) *it );	\
-	FILL_JOB_QUEUE_END()
-
-#define FILL_JOB_QUEUE_PARAM(_vec_type,_vec,_job_type,_condition)	\
-	FILL_JOB_QUEUE_BEGIN(_vec_type,_vec,_condition)			\
-	MixerWorkerThread::s_jobQueue.items				\
-		[MixerWorkerThread::s_jobQueue.queueSize] =		\
-			MixerWorkerThread::JobQueueItem( _job_type,	\
-							NULL, *it );	\
-	FILL_JOB_QUEUE_END()
-
-#define START_JOBS()							\
-	m_queueReadyWaitCond.wakeAll();
-
-// define a pause instruction for spinlock-loop - merely useful on
-// HyperThreading systems with just one physical core (e.g. Intel Atom)
-#ifdef LMMS_HOST_X86
-#define SPINLOCK_PAUSE()        asm( "pause" )
-#else
-#ifdef LMMS_HOST_X86_64
-#define SPINLOCK_PAUSE()        asm( "pause" )
-#else
-#define SPINLOCK_PAUSE()
-#endif
-#endif
-
-#define WAIT_FOR_JOBS()							\
-	m_workers[m_numWorkers]->processJobQueue();			\
-	while( MixerWorkerThread::s_jobQueue.itemsDone <		\
-			MixerWorkerThread::s_jobQueue.queueSize )	\
-	{								\
-		SPINLOCK_PAUSE();					\
-	}								\
-
-
-
-
 Mixer::Mixer() :
 	m_framesPerPeriod( DEFAULT_BUFFER_SIZE ),
 	m_workingBuf( NULL ),
@@ -306,12 +75,21 @@ Mixer::Mixer() :
 	m_cpuLoad( 0 ),
 	m_workers(),
 	m_numWorkers( QThread::idealThreadCount()-1 ),
-	m_queueReadyWaitCond(),
 	m_qualitySettings( qualitySettings::Mode_Draft ),
 	m_masterGain( 1.0f ),
 	m_audioDev( NULL ),
 	m_oldAudioDev( NULL ),
-	m_globalMutex( QMutex::Recursive )
+	m_globalMutex( QMutex::Recursive ),
+	m_lockDepth( 0 ),
+	m_nextFifoBuffer( 0 ),
+	m_adaptiveLatency( false ),
+	m_minFifoDepth( 1 ),
+	m_maxFifoDepth( 1 ),
+	m_fifoUnderruns( 0 ),
+	m_fifoPrimed( false ),
+	m_stablePeriods( 0 ),
+	m_metronomeSample( NULL ),
+	m_metronomePort( NULL )
 {
 	for( int i = 0; i < 2; ++i )
 	{
@@ -321,16 +99,12 @@ Mixer::Mixer() :
 		clearAudioBuffer( m_inputBuffer[i], m_inputBufferSize[i] );
 	}
 
-	for( int i = 1; i < NumFxChannels+1; ++i )
-	{
-		__fx_channel_jobs[i-1] = (fx_ch_t) i;
-	}
+	int fifoDepth = 1;
 
 	// just rendering?
 	if( !engine::hasGUI() )
 	{
 		m_framesPerPeriod = DEFAULT_BUFFER_SIZE;
-		m_fifo = new fifo( 1 );
 	}
 	else if( configManager::inst()->value( "mixer", "framesperaudiobuffer"
 						).toInt() >= 32 )
@@ -341,35 +115,64 @@ Mixer::Mixer() :
 
 		if( m_framesPerPeriod > DEFAULT_BUFFER_SIZE )
 		{
-			m_fifo = new fifo( m_framesPerPeriod
-							/ DEFAULT_BUFFER_SIZE );
+			fifoDepth = m_framesPerPeriod / DEFAULT_BUFFER_SIZE;
 			m_framesPerPeriod = DEFAULT_BUFFER_SIZE;
 		}
-		else
-		{
-			m_fifo = new fifo( 1 );
-		}
 	}
 	else
 	{
 		configManager::inst()->setValue( "mixer",
 							"framesperaudiobuffer",
 				QString::number( m_framesPerPeriod ) );
-		m_fifo = new fifo( 1 );
 	}
 
-	m_workingBuf = (sampleFrame*) aligned_malloc( m_framesPerPeriod *
-							sizeof( sampleFrame ) );
+	// with adaptive latency the fifo is allocated for the maximum depth
+	// and the configured buffer size only determines the initial depth
+	m_adaptiveLatency = engine::hasGUI() && configManager::inst()->value(
+					"mixer", "adaptivelatency" ).toInt();
+	if( m_adaptiveLatency )
+	{
+		m_minFifoDepth = qMax( 1, configManager::inst()->value(
+					"mixer", "minfifodepth" ).toInt() );
+		m_maxFifoDepth = configManager::inst()->value(
+					"mixer", "maxfifodepth" ).toInt();
+		if( m_maxFifoDepth < m_minFifoDepth )
+		{
+			m_maxFifoDepth = qMax( m_minFifoDepth,
+						DefaultMaxFifoDepth );
+		}
+		fifoDepth = qBound( m_minFifoDepth, fifoDepth,
+							m_maxFifoDepth );
+		m_fifo = new fifo( m_maxFifoDepth );
+		m_fifo->setLimit( fifoDepth );
+	}
+	else
+	{
+		m_fifo = new fifo( fifoDepth );
+	}
+
+	m_workingBuf = (sampleFrame*) MemoryHelper::alignedMalloc(
+				m_framesPerPeriod * sizeof( sampleFrame ) );
 	for( int i = 0; i < 3; i++ )
 	{
 		m_readBuf = (surroundSampleFrame*)
-			aligned_malloc( m_framesPerPeriod *
+			MemoryHelper::alignedMalloc( m_framesPerPeriod *
 						sizeof( surroundSampleFrame ) );
 
 		clearAudioBuffer( m_readBuf, m_framesPerPeriod );
 		m_bufferPool.push_back( m_readBuf );
 	}
 
+	for( int i = 0; i < m_fifo->size() + 2; ++i )
+	{
+		m_fifoBuffers.push_back( (surroundSampleFrame *)
+			MemoryHelper::alignedMalloc( m_framesPerPeriod *
+					sizeof( surroundSampleFrame ) ) );
+	}
+
+	// one queue for each worker thread plus one for the thread calling
+	// renderNextBuffer()
+	MixerWorkerThread::s_jobQueue.setWorkerCount( m_numWorkers+1 );
 	for( int i = 0; i < m_numWorkers+1; ++i )
 	{
 		MixerWorkerThread * wt = new MixerWorkerThread( i, this );
@@ -383,6 +186,27 @@ Mixer::Mixer() :
 	m_poolDepth = 2;
 	m_readBuffer = 0;
 	m_writeBuffer = 1;
+
+	// avoid page faults when touching buffers for the first time
+	// while rendering
+	RealtimeHelper::lockMemory();
+	RealtimeHelper::prefault( m_workingBuf,
+				m_framesPerPeriod * sizeof( sampleFrame ) );
+	for( int i = 0; i < m_bufferPool.size(); ++i )
+	{
+		RealtimeHelper::prefault( m_bufferPool[i], m_framesPerPeriod *
+						sizeof( surroundSampleFrame ) );
+	}
+	for( int i = 0; i < m_fifoBuffers.size(); ++i )
+	{
+		RealtimeHelper::prefault( m_fifoBuffers[i], m_framesPerPeriod *
+						sizeof( surroundSampleFrame ) );
+	}
+	for( int i = 0; i < 2; ++i )
+	{
+		RealtimeHelper::prefault( m_inputBuffer[i],
+				m_inputBufferSize[i] * sizeof( sampleFrame ) );
+	}
 }
 
 
@@ -390,34 +214,38 @@ Mixer::Mixer() :
 
 Mixer::~Mixer()
 {
-	// distribute an empty job-queue so that worker-threads
-	// get out of their processing-loop
-	MixerWorkerThread::s_jobQueue.queueSize = 0;
+	// make worker-threads get out of their processing-loop
+	MixerWorkerThread::s_jobQueue.reset();
 	for( int w = 0; w < m_numWorkers; ++w )
 	{
 		m_workers[w]->quit();
 	}
-	START_JOBS();
+	MixerWorkerThread::s_jobQueue.wakeUp().notifyAll();
 	for( int w = 0; w < m_numWorkers; ++w )
 	{
 		m_workers[w]->wait( 500 );
 	}
 
+	// buffers still queued are part of m_fifoBuffers
 	while( m_fifo->available() )
 	{
-		delete[] m_fifo->read();
+		m_fifo->read();
 	}
 	delete m_fifo;
+	for( int i = 0; i < m_fifoBuffers.size(); ++i )
+	{
+		MemoryHelper::alignedFree( m_fifoBuffers[i] );
+	}
 
 	delete m_audioDev;
 	delete m_midiClient;
 
 	for( int i = 0; i < 3; i++ )
 	{
-		aligned_free( m_bufferPool[i] );
+		MemoryHelper::alignedFree( m_bufferPool[i] );
 	}
 
-	aligned_free( m_workingBuf );
+	MemoryHelper::alignedFree( m_workingBuf );
 
 	for( int i = 0; i < 2; ++i )
 	{
@@ -437,8 +265,32 @@ void Mixer::initDevices()
 
 
 
+void Mixer::createMetronome()
+{
+	m_metronomeSample = new SampleBuffer( "misc/metronome01.ogg" );
+	m_metronomePort = new AudioPort( "Metronome", false );
+}
+
+
+
+
+void Mixer::destroyMetronome()
+{
+	// play-handles still using them don't delete the port and hold their
+	// own reference to the sample
+	delete m_metronomePort;
+	m_metronomePort = NULL;
+	sharedObject::unref( m_metronomeSample );
+	m_metronomeSample = NULL;
+}
+
+
+
+
 void Mixer::startProcessing( bool _needs_fifo )
 {
+	m_commandQueue.setActive( true );
+
 	if( _needs_fifo )
 	{
 		m_fifoWriter = new fifoWriter( this, m_fifo );
@@ -470,6 +322,8 @@ void Mixer::stopProcessing()
 	{
 		m_audioDev->stopProcessing();
 	}
+
+	m_commandQueue.setActive( false );
 }
 
 
@@ -553,9 +407,50 @@ void Mixer::pushInputFrames( sampleFrame * _ab, const f_cnt_t _frames )
 
 
 
+const surroundSampleFrame * Mixer::nextBuffer()
+{
+	if( hasFifoWriter() )
+	{
+		if( m_fifoPrimed && m_fifo->available() == 0 )
+		{
+			m_fifoUnderruns.fetchAndAddOrdered( 1 );
+		}
+		const qint64 start = RenderTracer::now();
+		surroundSampleFrame * b = m_fifo->read();
+		m_tracer.record( m_numWorkers+1, RenderTracer::FifoRead, start );
+		m_fifoPrimed = true;
+		return b;
+	}
+	return renderNextBuffer();
+}
+
+
+
+
+void Mixer::startTracing()
+{
+	// one lane per worker (including thread rendering periods) plus
+	// one for the audio device
+	m_tracer.start( m_numWorkers+2 );
+}
+
+
+
+
+void Mixer::stopTracing()
+{
+	m_tracer.stop();
+}
+
+
+
+
 const surroundSampleFrame * Mixer::renderNextBuffer()
 {
+	AllocationTracker::beginPeriod();
+	const qint64 traceStart = RenderTracer::now();
 	MicroTimer timer;
+	m_profiler.startPeriod();
 	static song::playPos last_metro_pos = -1;
 
 	song::playPos p = engine::getSong()->getPlayPos(
@@ -565,7 +460,8 @@ const surroundSampleFrame * Mixer::renderNextBuffer()
 		p != last_metro_pos && p.getTicks() %
 					(DefaultTicksPerTact / 4 ) == 0 )
 	{
-		addPlayHandle( new SamplePlayHandle( "misc/metronome01.ogg" ) );
+		addPlayHandle( new SamplePlayHandle( m_metronomeSample,
+							m_metronomePort ) );
 		last_metro_pos = p;
 	}
 
@@ -582,23 +478,12 @@ const surroundSampleFrame * Mixer::renderNextBuffer()
 	// while we're acting...
 	lock();
 
-	// remove all play-handles that have to be deleted and delete
-	// them if they still exist...
-	// maybe this algorithm could be optimized...
-	ConstPlayHandleList::Iterator it_rem = m_playHandlesToRemove.begin();
-	while( it_rem != m_playHandlesToRemove.end() )
-	{
-		PlayHandleList::Iterator it = qFind( m_playHandles.begin(),
-						m_playHandles.end(), *it_rem );
-
-		if( it != m_playHandles.end() )
-		{
-			delete *it;
-			m_playHandles.erase( it );
-		}
+	// add new play-handles and remove the ones which were requested to
+	// be removed
+	processQueuedPlayHandles();
 
-		it_rem = m_playHandlesToRemove.erase( it_rem );
-	}
+	// apply changes made by other threads since last period
+	m_commandQueue.process();
 
 	// rotate buffers
 	m_writeBuffer = ( m_writeBuffer + 1 ) % m_poolDepth;
@@ -610,34 +495,41 @@ const surroundSampleFrame * Mixer::renderNextBuffer()
 	// clear last audio-buffer
 	clearAudioBuffer( m_writeBuf, m_framesPerPeriod );
 
-	// prepare master mix (clear internal buffers etc.)
-	engine::fxMixer()->prepareMasterMix();
-
-	// create play-handles for new notes, samples etc.
+	// create play-handles for new notes, samples etc. and let automation
+	// fill value buffers of this period
+	AutomatableModel::nextPeriod();
 	engine::getSong()->processNextBuffer();
+	m_profiler.finishStage( RenderProfiler::Stage_Song );
 
+	// notes and samples started by song have offsets within this period,
+	// so they have to go live right now
+	processQueuedPlayHandles();
 
-	// STAGE 1: run and render all play handles
-	FILL_JOB_QUEUE(PlayHandleList,m_playHandles,
-					MixerWorkerThread::PlayHandle,
-					!( *it )->done());
-	START_JOBS();
-	WAIT_FOR_JOBS();
+
+	// STAGE 1: render all play handles, process effects of all instrument-
+	// and sampletracks and process effects in FX mixer - every job is
+	// started as soon as all jobs it depends on are finished
+	buildRenderGraph();
+	m_profiler.finishStage( RenderProfiler::Stage_Graph );
+	m_workers[m_numWorkers]->processJobQueue();
+	m_profiler.finishStage( RenderProfiler::Stage_Jobs );
 
 	// removed all play handles which are done
 	for( PlayHandleList::Iterator it = m_playHandles.begin();
 						it != m_playHandles.end(); )
 	{
-		if( ( *it )->affinityMatters() &&
-			( *it )->affinity() != QThread::currentThread() )
+		if( ( ( *it )->affinityMatters() &&
+			( *it )->affinity() != QThread::currentThread() ) ||
+						( *it )->m_removalRequested )
 		{
 			++it;
 			continue;
 		}
 		if( ( *it )->done() )
 		{
-			delete *it;
+			playHandle * ph = *it;
 			it = m_playHandles.erase( it );
+			delete ph;
 		}
 		else
 		{
@@ -646,22 +538,11 @@ const surroundSampleFrame * Mixer::renderNextBuffer()
 	}
 
 
-	// STAGE 2: process effects of all instrument- and sampletracks
-	FILL_JOB_QUEUE(QVector<AudioPort*>,m_audioPorts,
-					MixerWorkerThread::AudioPortEffects,1);
-	START_JOBS();
-	WAIT_FOR_JOBS();
-
-
-	// STAGE 3: process effects in FX mixer
-	FILL_JOB_QUEUE_PARAM(QVector<fx_ch_t>,__fx_channel_jobs,
-					MixerWorkerThread::EffectChannel,1);
-	START_JOBS();
-	WAIT_FOR_JOBS();
-
-
-	// STAGE 4: do master mix in FX mixer
+	// STAGE 2: do master mix in FX mixer
 	engine::fxMixer()->masterMix( m_writeBuf );
+	m_profiler.finishStage( RenderProfiler::Stage_MasterMix );
+
+	finishProfilingPeriod();
 
 	unlock();
 
@@ -677,18 +558,179 @@ const surroundSampleFrame * Mixer::renderNextBuffer()
 	m_cpuLoad = tLimit( (int) ( new_cpu_load * 0.1f + m_cpuLoad * 0.9f ), 0,
 									100 );
 
+	const int periodLength = (int)( m_framesPerPeriod * 1000000.0f /
+						processingSampleRate() );
+	m_profiler.finishPeriod( periodLength );
+	if( m_audioDev != NULL )
+	{
+		m_audioDev->recordRenderTime( timer.elapsed(), periodLength );
+	}
+	m_tracer.record( m_numWorkers, RenderTracer::Period, traceStart );
+	AllocationTracker::endPeriod();
+
 	return m_readBuf;
 }
 
 
 
 
+void Mixer::finishProfilingPeriod()
+{
+	FxMixer * fxm = engine::fxMixer();
+
+	// time spent for audio ports also counts for the FX channel they're
+	// routed to
+	for( QVector<AudioPort *>::Iterator it = m_audioPorts.begin();
+						it != m_audioPorts.end(); ++it )
+	{
+		AudioPort * port = *it;
+		port->m_profile.finishPeriod();
+		if( port->effects() )
+		{
+			port->effects()->finishProfilingPeriod();
+		}
+		FxChannel * ch = fxm->effectChannel( port->nextFxChannel() );
+		if( ch != NULL )
+		{
+			ch->m_inputProfile.add( port->m_profile.time() );
+		}
+	}
+
+	for( int i = 0; i <= fxm->numChannels(); ++i )
+	{
+		FxChannel * ch = fxm->effectChannel( i );
+		ch->m_profile.finishPeriod();
+		ch->m_inputProfile.finishPeriod();
+		ch->m_fxChain.finishProfilingPeriod();
+	}
+}
+
+
+
+
+void Mixer::adaptFifoDepth( int _renderTime )
+{
+	// time (in microseconds) without problems before decreasing latency
+	const int StableTime = 10000000;
+
+	const int periodLength = (int)( m_framesPerPeriod * 1000000.0f /
+						processingSampleRate() );
+	const int depth = m_fifo->limit();
+
+	if( m_fifoUnderruns.fetchAndStoreOrdered( 0 ) > 0 ||
+					_renderTime > periodLength * 8 / 10 )
+	{
+		m_stablePeriods = 0;
+		if( depth < m_maxFifoDepth )
+		{
+			m_fifo->setLimit( depth+1 );
+			RealtimeLog::post( "Mixer: increased output latency to "
+						"%d periods", depth+1 );
+		}
+		return;
+	}
+
+	// only periods leaving enough headroom count as stable
+	m_stablePeriods = _renderTime < periodLength / 2 ?
+						m_stablePeriods + 1 : 0;
+	if( m_stablePeriods >= StableTime / periodLength &&
+						depth > m_minFifoDepth )
+	{
+		m_stablePeriods = 0;
+		m_fifo->setLimit( depth-1 );
+		RealtimeLog::post( "Mixer: decreased output latency to "
+						"%d periods", depth-1 );
+	}
+}
+
+
+
+
+void Mixer::buildRenderGraph()
+{
+	MixerWorkerThread::JobQueue & queue = MixerWorkerThread::s_jobQueue;
+	queue.reset();
+
+	FxMixer * fxm = engine::fxMixer();
+
+	// FX channels any audio port is routed to and the ones which still
+	// have effects running - all other channels are silent. Master
+	// channel is processed by FxMixer::masterMix() when everything's done
+	for( QVector<AudioPort *>::Iterator it = m_audioPorts.begin();
+						it != m_audioPorts.end(); ++it )
+	{
+		fxm->activateChannel( ( *it )->nextFxChannel() );
+	}
+	const QVector<fx_ch_t> & channels = fxm->activeChannels();
+	for( QVector<fx_ch_t>::ConstIterator it = channels.begin();
+						it != channels.end(); ++it )
+	{
+		FxChannel * ch = fxm->effectChannel( *it );
+		ch->m_renderJob = queue.addJob(
+					MixerWorkerThread::EffectChannel,
+						NULL, *it,
+						MixerWorkerThread::NoSuccessor,
+							ch->m_renderCost );
+	}
+
+	// audio ports - each one depends on all play handles rendering into it
+	// and the FX channel it's routed to depends on it
+	const int firstPortJob = queue.size();
+	for( QVector<AudioPort *>::Iterator it = m_audioPorts.begin();
+						it != m_audioPorts.end(); ++it )
+	{
+		const fx_ch_t ch = ( *it )->nextFxChannel();
+		const int successor = ( ch > 0 && ch <= fxm->numChannels() ) ?
+				fxm->effectChannel( ch )->m_renderJob :
+					MixerWorkerThread::NoSuccessor;
+		if( ch >= 0 && ch <= fxm->numChannels() )
+		{
+			fxm->addInput( ch, *it );
+		}
+		( *it )->m_renderJob = queue.addJob(
+					MixerWorkerThread::AudioPortEffects,
+						*it, ch, successor,
+						( *it )->m_renderCost );
+		queue.addDependency( successor );
+	}
+	queue.setAudioPortJobs( firstPortJob, queue.size() - firstPortJob );
+
+	// play handles - if we don't know which audio port a play handle
+	// renders into, all audio ports have to wait for it
+	for( PlayHandleList::Iterator it = m_playHandles.begin();
+						it != m_playHandles.end(); ++it )
+	{
+		if( ( *it )->done() )
+		{
+			continue;
+		}
+		const AudioPort * port = ( *it )->audioPort();
+		int successor = MixerWorkerThread::AllAudioPorts;
+		if( port != NULL && port->m_renderJob >= firstPortJob &&
+				port->m_renderJob < queue.size() &&
+				queue.item( port->m_renderJob ).job == port )
+		{
+			successor = port->m_renderJob;
+		}
+		queue.addJob( MixerWorkerThread::PlayHandle, *it, 0,
+					successor, ( *it )->renderCost() );
+		queue.addDependency( successor );
+	}
+
+	// also wakes up workers
+	queue.start();
+}
+
+
+
+
 // removes all play-handles. this is necessary, when the song is stopped ->
 // all remaining notes etc. would be played until their end
 void Mixer::clear()
 {
 	// TODO: m_midiClient->noteOffAll();
 	lock();
+	processQueuedPlayHandles();
 	for( PlayHandleList::Iterator it = m_playHandles.begin();
 					it != m_playHandles.end(); ++it )
 	{
@@ -696,7 +738,7 @@ void Mixer::clear()
 		// during the whole lifetime of an instrument
 		if( ( *it )->type() != playHandle::InstrumentPlayHandle )
 		{
-			m_playHandlesToRemove.push_back( *it );
+			requestRemoval( *it );
 		}
 	}
 	unlock();
@@ -711,6 +753,12 @@ void Mixer::bufferToPort( const sampleFrame * _buf,
 					stereoVolumeVector _vv,
 						AudioPort * _port )
 {
+	if( _vv.vol[0] == 0.0f && _vv.vol[1] == 0.0f )
+	{
+		// port stays silent
+		return;
+	}
+
 	const int start_frame = _offset % m_framesPerPeriod;
 	int end_frame = start_frame + _frames;
 	const int loop1_frame = qMin<int>( end_frame, m_framesPerPeriod );
@@ -769,19 +817,9 @@ void Mixer::clearAudioBuffer( surroundSampleFrame * _ab, const f_cnt_t _frames,
 
 float Mixer::peakValueLeft( sampleFrame * _ab, const f_cnt_t _frames )
 {
-	float p = 0.0f;
-	for( f_cnt_t f = 0; f < _frames; ++f )
-	{
-		if( _ab[f][0] > p )
-		{
-			p = _ab[f][0];
-		}
-		else if( -_ab[f][0] > p )
-		{
-			p = -_ab[f][0];
-		}
-	}
-	return p;
+	float l, r;
+	MixHelpers::peakValues( _ab, _frames, &l, &r );
+	return l;
 }
 
 
@@ -789,19 +827,9 @@ float Mixer::peakValueLeft( sampleFrame * _ab, const f_cnt_t _frames )
 
 float Mixer::peakValueRight( sampleFrame * _ab, const f_cnt_t _frames )
 {
-	float p = 0.0f;
-	for( f_cnt_t f = 0; f < _frames; ++f )
-	{
-		if( _ab[f][1] > p )
-		{
-			p = _ab[f][1];
-		}
-		else if( -_ab[f][1] > p )
-		{
-			p = -_ab[f][1];
-		}
-	}
-	return p;
+	float l, r;
+	MixHelpers::peakValues( _ab, _frames, &l, &r );
+	return r;
 }
 
 
@@ -913,28 +941,41 @@ void Mixer::removeAudioPort( AudioPort * _port )
 
 
 
+bool Mixer::addPlayHandle( playHandle * _ph )
+{
+	if( criticalXRuns() == false )
+	{
+		pushPlayHandle( m_newPlayHandles, _ph );
+		return true;
+	}
+	delete _ph;
+	return false;
+}
+
+
+
+
 void Mixer::removePlayHandle( playHandle * _ph )
 {
-	lock();
 	// check thread affinity as we must not delete play-handles
 	// which were created in a thread different than mixer thread
 	if( _ph->affinityMatters() &&
 				_ph->affinity() == QThread::currentThread() )
 	{
-		PlayHandleList::Iterator it =
-				qFind( m_playHandles.begin(),
-						m_playHandles.end(), _ph );
-		if( it != m_playHandles.end() )
+		lock();
+		processQueuedPlayHandles();
+		if( m_playHandles.contains( _ph ) &&
+					_ph->m_removalRequested == false )
 		{
-			m_playHandles.erase( it );
+			m_playHandles.remove( _ph );
 			delete _ph;
 		}
+		unlock();
 	}
 	else
 	{
-		m_playHandlesToRemove.push_back( _ph );
+		requestRemoval( _ph );
 	}
-	unlock();
 }
 
 
@@ -943,13 +984,18 @@ void Mixer::removePlayHandle( playHandle * _ph )
 void Mixer::removePlayHandles( track * _track )
 {
 	lock();
+	processQueuedPlayHandles();
 	PlayHandleList::Iterator it = m_playHandles.begin();
 	while( it != m_playHandles.end() )
 	{
-		if( ( *it )->isFromTrack( _track ) )
+		// handles with pending removal request are deleted when
+		// queue is processed next time
+		if( ( *it )->isFromTrack( _track ) &&
+				( *it )->m_removalRequested == false )
 		{
-			delete *it;
+			playHandle * ph = *it;
 			it = m_playHandles.erase( it );
+			delete ph;
 		}
 		else
 		{
@@ -962,9 +1008,84 @@ void Mixer::removePlayHandles( track * _track )
 
 
 
+void Mixer::pushPlayHandle( AtomicPointer<playHandle> & _stack,
+							playHandle * _ph )
+{
+	playHandle * head;
+	do
+	{
+		head = _stack;
+		_ph->m_nextQueued = head;
+	} while( !_stack.testAndSetOrdered( head, _ph ) );
+}
+
+
+
+
+void Mixer::requestRemoval( playHandle * _ph )
+{
+	// play-handle is deleted with next call of processQueuedPlayHandles()
+	// and must not be deleted by anyone else until then
+	if( _ph->m_removalRequested == false )
+	{
+		_ph->m_removalRequested = true;
+		pushPlayHandle( m_playHandlesToRemove, _ph );
+	}
+}
+
+
+
+
+void Mixer::processQueuedPlayHandles()
+{
+	// stack has reverse order, so turn it around to keep order in which
+	// play-handles were added
+	playHandle * ph = m_newPlayHandles.fetchAndStoreOrdered( NULL );
+	playHandle * reversed = NULL;
+	while( ph != NULL )
+	{
+		playHandle * next = ph->m_nextQueued;
+		ph->m_nextQueued = reversed;
+		reversed = ph;
+		ph = next;
+	}
+	while( reversed != NULL )
+	{
+		playHandle * next = reversed->m_nextQueued;
+		reversed->m_nextQueued = NULL;
+		m_playHandles.push_back( reversed );
+		if( reversed->type() == playHandle::NotePlayHandle )
+		{
+			// make it known to its track for cheap lookup of
+			// other notes of the same track (e.g. by arpeggiator)
+			static_cast<notePlayHandle *>( reversed )->
+							registerVoice();
+		}
+		reversed = next;
+	}
+
+	ph = m_playHandlesToRemove.fetchAndStoreOrdered( NULL );
+	while( ph != NULL )
+	{
+		playHandle * next = ph->m_nextQueued;
+		// nobody else deletes a handle once removal was requested, so
+		// if it isn't in our list, it never has been added
+		if( m_playHandles.contains( ph ) )
+		{
+			m_playHandles.remove( ph );
+			delete ph;
+		}
+		ph = next;
+	}
+}
+
+
+
+
 bool Mixer::hasNotePlayHandles()
 {
 	lock();
+	processQueuedPlayHandles();
 
 	for( PlayHandleList::Iterator it = m_playHandles.begin();
 			it != m_playHandles.end(); ++it )
@@ -1189,24 +1310,27 @@ void Mixer::fifoWriter::finish()
 
 void Mixer::fifoWriter::run()
 {
-#if 0
-#ifdef LMMS_BUILD_LINUX
-#ifdef LMMS_HAVE_SCHED_H
-	cpu_set_t mask;
-	CPU_ZERO( &mask );
-	CPU_SET( 0, &mask );
-	sched_setaffinity( 0, sizeof( mask ), &mask );
-#endif
-#endif
-#endif
+	// the thread rendering periods acts as last worker
+	RealtimeHelper::setupThread( m_mixer->numWorkers()-1 );
 
 	const fpp_t frames = m_mixer->framesPerPeriod();
 	while( m_writing )
 	{
-		surroundSampleFrame * buffer = new surroundSampleFrame[frames];
+		surroundSampleFrame * buffer =
+			m_mixer->m_fifoBuffers[m_mixer->m_nextFifoBuffer];
+		m_mixer->m_nextFifoBuffer = ( m_mixer->m_nextFifoBuffer + 1 ) %
+						m_mixer->m_fifoBuffers.size();
+		MicroTimer timer;
 		const surroundSampleFrame * b = m_mixer->renderNextBuffer();
+		if( m_mixer->m_adaptiveLatency )
+		{
+			m_mixer->adaptFifoDepth( timer.elapsed() );
+		}
 		memcpy( buffer, b, frames * sizeof( surroundSampleFrame ) );
+		const qint64 start = RenderTracer::now();
 		m_fifo->write( buffer );
+		m_mixer->m_tracer.record( m_mixer->m_numWorkers,
+					RenderTracer::FifoWrite, start );
 	}
 
 	m_fifo->write( NULL );
@@ -0,0 +1,630 @@
+/*
+ * MixerWorkerThread.cpp - implementation of MixerWorkerThread
+ *
+ * Copyright (c) 2014 Tobias Doerffel <tobydox/at/users.sourceforge.net>
+ *
+ * This file is part of Linux MultiMedia Studio - http://lmms.sourceforge.net
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <QtCore/QtAlgorithms>
+
+#include "MixerWorkerThread.h"
+#include "AudioPort.h"
+#include "FxMixer.h"
+#include "MemoryHelper.h"
+#include "MicroTimer.h"
+#include "RealtimeHelper.h"
+#include "engine.h"
+
+
+MixerWorkerThread::JobQueue MixerWorkerThread::s_jobQueue;
+
+// number of times a worker checks for work before going to sleep
+static const int WorkerSpinCount = 4096;
+
+
+
+MixerWorkerThread::WorkerQueue::WorkerQueue() :
+	m_top( 0 ),
+	m_bottom( 0 ),
+	m_items()
+{
+}
+
+
+
+
+void MixerWorkerThread::WorkerQueue::reset( int _capacity )
+{
+	if( m_items.size() < _capacity )
+	{
+		m_items.resize( _capacity );
+	}
+	m_top = 0;
+	m_bottom = 0;
+}
+
+
+
+
+void MixerWorkerThread::WorkerQueue::push( int _item )
+{
+	// each job is pushed only once per period so we never run out of
+	// space and never have to wrap around
+	const int b = m_bottom;
+	m_items[b] = _item;
+	m_bottom.fetchAndStoreOrdered( b+1 );
+}
+
+
+
+
+int MixerWorkerThread::WorkerQueue::pop()
+{
+	const int b = m_bottom - 1;
+	m_bottom.fetchAndStoreOrdered( b );
+	const int t = m_top;
+	if( t > b )
+	{
+		// queue is empty
+		m_bottom.fetchAndStoreOrdered( b+1 );
+		return -1;
+	}
+	int item = m_items[b];
+	if( t == b )
+	{
+		// last job in queue - compete with thieves for it
+		if( m_top.testAndSetOrdered( t, t+1 ) == false )
+		{
+			item = -1;
+		}
+		m_bottom.fetchAndStoreOrdered( b+1 );
+	}
+	return item;
+}
+
+
+
+
+int MixerWorkerThread::WorkerQueue::steal()
+{
+	const int t = m_top;
+	const int b = m_bottom;
+	if( t >= b )
+	{
+		return -1;
+	}
+	const int item = m_items[t];
+	if( m_top.testAndSetOrdered( t, t+1 ) == false )
+	{
+		return -1;
+	}
+	return item;
+}
+
+
+
+
+
+
+// helper for sorting jobs by cost, most expensive first
+class JobCostGreater
+{
+public:
+	JobCostGreater( const MixerWorkerThread::JobQueue * _queue ) :
+		m_queue( _queue )
+	{
+	}
+
+	bool operator()( int _a, int _b ) const
+	{
+		return m_queue->item( _a ).cost > m_queue->item( _b ).cost;
+	}
+
+
+private:
+	const MixerWorkerThread::JobQueue * m_queue;
+
+} ;
+
+
+
+
+MixerWorkerThread::JobQueue::JobQueue() :
+	m_items(),
+	m_queueSize( 0 ),
+	m_itemsDone( 0 ),
+	m_started( 0 ),
+	m_epoch( 0 ),
+	m_activeWorkers( 0 ),
+	m_wakeUp(),
+	m_firstAudioPortJob( 0 ),
+	m_numAudioPortJobs( 0 ),
+	m_workerQueues(),
+	m_readyItems()
+{
+}
+
+
+
+
+MixerWorkerThread::JobQueue::~JobQueue()
+{
+	setWorkerCount( 0 );
+}
+
+
+
+
+void MixerWorkerThread::JobQueue::setWorkerCount( int _workers )
+{
+	for( int i = 0; i < m_workerQueues.size(); ++i )
+	{
+		delete m_workerQueues[i];
+	}
+	m_workerQueues.clear();
+	for( int i = 0; i < _workers; ++i )
+	{
+		m_workerQueues.push_back( new WorkerQueue );
+	}
+}
+
+
+
+
+void MixerWorkerThread::JobQueue::reset()
+{
+	m_started.fetchAndStoreOrdered( 0 );
+	// workers which entered previous period might still be on their way
+	// out - don't pull the rug out from under them
+	while( m_activeWorkers > 0 )
+	{
+		SPINLOCK_PAUSE();
+	}
+	m_queueSize = 0;
+	m_itemsDone = 0;
+	m_firstAudioPortJob = 0;
+	m_numAudioPortJobs = 0;
+}
+
+
+
+
+int MixerWorkerThread::JobQueue::addJob( JobTypes _type, void * _job,
+				int _param, int _successor, int _cost )
+{
+	const int idx = m_queueSize;
+	if( idx >= m_items.size() )
+	{
+		m_items.resize( qMax( 64, m_items.size() * 2 ) );
+	}
+	JobQueueItem & it = m_items[idx];
+	it.type = _type;
+	it.job = _job;
+	it.param = _param;
+	it.successor = _successor;
+	it.cost = _cost;
+	it.pending = 0;
+	m_queueSize = idx + 1;
+	return idx;
+}
+
+
+
+
+void MixerWorkerThread::JobQueue::addDependency( int _item )
+{
+	if( _item == AllAudioPorts )
+	{
+		for( int i = 0; i < m_numAudioPortJobs; ++i )
+		{
+			m_items[m_firstAudioPortJob+i].pending.
+							fetchAndAddOrdered( 1 );
+		}
+	}
+	else if( _item >= 0 )
+	{
+		m_items[_item].pending.fetchAndAddOrdered( 1 );
+	}
+}
+
+
+
+
+void MixerWorkerThread::JobQueue::start()
+{
+	const int numQueues = m_workerQueues.size();
+	for( int w = 0; w < numQueues; ++w )
+	{
+		m_workerQueues[w]->reset( m_queueSize );
+	}
+
+	m_readyItems.clear();
+	for( int i = 0; i < m_queueSize; ++i )
+	{
+		if( m_items[i].pending == 0 )
+		{
+			m_readyItems.push_back( i );
+		}
+	}
+	qSort( m_readyItems.begin(), m_readyItems.end(),
+						JobCostGreater( this ) );
+
+	// deal jobs round-robin - push cheapest first so that each worker
+	// pops its most expensive job first
+	for( int i = m_readyItems.size()-1; i >= 0; --i )
+	{
+		m_workerQueues[i % numQueues]->push( m_readyItems[i] );
+	}
+
+	m_started.fetchAndStoreOrdered( 1 );
+	m_epoch.fetchAndAddOrdered( 1 );
+	m_wakeUp.notifyAll();
+}
+
+
+
+
+bool MixerWorkerThread::JobQueue::enter()
+{
+	m_activeWorkers.fetchAndAddOrdered( 1 );
+	if( m_started == 0 )
+	{
+		m_activeWorkers.fetchAndAddOrdered( -1 );
+		return false;
+	}
+	return true;
+}
+
+
+
+
+void MixerWorkerThread::JobQueue::leave()
+{
+	m_activeWorkers.fetchAndAddOrdered( -1 );
+}
+
+
+
+
+int MixerWorkerThread::JobQueue::takeReadyItem( int _worker )
+{
+	const int item = m_workerQueues[_worker]->pop();
+	if( item >= 0 )
+	{
+		return item;
+	}
+
+	// nothing left in own queue, so try to steal from others
+	const int numQueues = m_workerQueues.size();
+	for( int i = 1; i < numQueues; ++i )
+	{
+		const int stolen =
+			m_workerQueues[( _worker + i ) % numQueues]->steal();
+		if( stolen >= 0 )
+		{
+			return stolen;
+		}
+	}
+	return -1;
+}
+
+
+
+
+void MixerWorkerThread::JobQueue::finishJob( int _item, int _worker )
+{
+	const int successor = m_items[_item].successor;
+	bool released = false;
+	if( successor == AllAudioPorts )
+	{
+		for( int i = 0; i < m_numAudioPortJobs; ++i )
+		{
+			released |= release( m_firstAudioPortJob+i, _worker );
+		}
+	}
+	else if( successor >= 0 )
+	{
+		released = release( successor, _worker );
+	}
+	const bool last = m_itemsDone.fetchAndAddOrdered( 1 ) + 1 >= m_queueSize;
+
+	// wake up sleeping workers if there's something new to do for them
+	// or if they can leave
+	if( released || last )
+	{
+		m_wakeUp.notifyAll();
+	}
+}
+
+
+
+
+bool MixerWorkerThread::JobQueue::release( int _item, int _worker )
+{
+	if( m_items[_item].pending.fetchAndAddOrdered( -1 ) == 1 )
+	{
+		m_workerQueues[_worker]->push( _item );
+		return true;
+	}
+	return false;
+}
+
+
+
+
+
+
+// conditions workers wait for
+class NewPeriodCondition
+{
+public:
+	NewPeriodCondition( const volatile bool & _quit, int _epoch ) :
+		m_quit( _quit ),
+		m_epoch( _epoch )
+	{
+	}
+
+	bool operator()()
+	{
+		return m_quit ||
+			MixerWorkerThread::s_jobQueue.epoch() != m_epoch;
+	}
+
+
+private:
+	const volatile bool & m_quit;
+	int m_epoch;
+
+} ;
+
+
+
+class ReadyJobCondition
+{
+public:
+	ReadyJobCondition( int _worker ) :
+		m_worker( _worker ),
+		m_item( -1 )
+	{
+	}
+
+	bool operator()()
+	{
+		m_item = MixerWorkerThread::s_jobQueue.takeReadyItem( m_worker );
+		return m_item >= 0 || MixerWorkerThread::s_jobQueue.isDone();
+	}
+
+	int item() const
+	{
+		return m_item;
+	}
+
+
+private:
+	int m_worker;
+	int m_item;
+
+} ;
+
+
+
+
+
+
+MixerWorkerThread::MixerWorkerThread( int _worker_num, Mixer* mixer ) :
+	QThread( mixer ),
+	m_workingBuf( (sampleFrame *) MemoryHelper::alignedMalloc(
+				mixer->framesPerPeriod() * sizeof( sampleFrame ) ) ),
+	m_workerNum( _worker_num ),
+	m_quit( false ),
+	m_mixer( mixer ),
+	m_statistics()
+{
+	RealtimeHelper::prefault( m_workingBuf,
+			mixer->framesPerPeriod() * sizeof( sampleFrame ) );
+}
+
+
+
+
+MixerWorkerThread::~MixerWorkerThread()
+{
+	MemoryHelper::alignedFree( m_workingBuf );
+}
+
+
+
+
+void MixerWorkerThread::quit()
+{
+	m_quit = true;
+}
+
+
+
+
+void MixerWorkerThread::processJobQueue()
+{
+	if( s_jobQueue.enter() == false )
+	{
+		return;
+	}
+
+	while( true )
+	{
+		int i = s_jobQueue.takeReadyItem( m_workerNum );
+		if( i < 0 )
+		{
+			if( s_jobQueue.isDone() )
+			{
+				break;
+			}
+			// jobs left but none of them is ready yet
+			ReadyJobCondition cond( m_workerNum );
+			waitFor( cond, RenderTracer::WaitForJobs );
+			if( ( i = cond.item() ) < 0 )
+			{
+				break;
+			}
+		}
+		processJob( s_jobQueue.item( i ) );
+		s_jobQueue.finishJob( i, m_workerNum );
+	}
+
+	s_jobQueue.leave();
+}
+
+
+
+
+template<class CONDITION>
+void MixerWorkerThread::waitFor( CONDITION & _cond,
+					RenderTracer::EventTypes _traceType )
+{
+	RenderTracer & tracer = m_mixer->m_tracer;
+	const qint64 start = tracer.isRecording() ? RenderTracer::now() : 0;
+	MicroTimer timer;
+	for( int i = 0; i < WorkerSpinCount; ++i )
+	{
+		if( _cond() )
+		{
+			m_statistics.spinTime += timer.elapsed();
+			tracer.record( m_workerNum, _traceType, start );
+			return;
+		}
+		SPINLOCK_PAUSE();
+	}
+
+	const int spun = timer.elapsed();
+	EventCount & wakeUp = s_jobQueue.wakeUp();
+	while( true )
+	{
+		const int key = wakeUp.prepareWait();
+		if( _cond() )
+		{
+			wakeUp.cancelWait();
+			break;
+		}
+		wakeUp.wait( key );
+		++m_statistics.sleeps;
+	}
+	m_statistics.spinTime += spun;
+	m_statistics.sleepTime += timer.elapsed() - spun;
+	tracer.record( m_workerNum, _traceType, start );
+}
+
+
+
+
+void MixerWorkerThread::processJob( const JobQueueItem & _it )
+{
+	RenderTracer & tracer = m_mixer->m_tracer;
+	const qint64 start = tracer.isRecording() ? RenderTracer::now() : 0;
+	MicroTimer timer;
+	switch( _it.type )
+	{
+		case PlayHandle:
+			{
+				playHandle * ph = (playHandle *) _it.job;
+				ph->play( m_workingBuf );
+				const int cost = timer.elapsed();
+				ph->setRenderCost( cost );
+				AudioPort * port = ph->audioPort();
+				if( port )
+				{
+					port->m_profile.add( cost );
+				}
+				tracer.record( m_workerNum,
+					RenderTracer::PlayHandleJob, start,
+					port ? port->m_traceName : -1 );
+			}
+			break;
+		case AudioPortEffects:
+			{
+				AudioPort * a = (AudioPort *) _it.job;
+				// nothing was written into a silent port, so
+				// only effects with a tail can produce output
+				const bool silent =
+					a->m_bufferUsage == AudioPort::NoUsage;
+				const bool me = ( !silent ||
+					( a->effects() &&
+						a->effects()->isRunning() ) ) &&
+							a->processEffects();
+				if( me || !silent )
+				{
+					// FX channel this port was routed to when
+					// building the render-graph mixes it in
+					// once all its inputs are done
+					if( engine::fxMixer()->effectChannel(
+							_it.param ) != NULL )
+					{
+						a->m_hasOutput = true;
+					}
+					else
+					{
+						a->nextPeriod();
+					}
+				}
+				a->m_renderCost = timer.elapsed();
+				a->m_profile.add( a->m_renderCost );
+				tracer.record( m_workerNum,
+					RenderTracer::AudioPortJob, start,
+							a->m_traceName );
+			}
+			break;
+		case EffectChannel:
+			{
+				engine::fxMixer()->mixInputs( (fx_ch_t) _it.param );
+				engine::fxMixer()->processChannel( (fx_ch_t) _it.param );
+				FxChannel * ch = engine::fxMixer()->
+						effectChannel( _it.param );
+				ch->m_renderCost = timer.elapsed();
+				ch->m_profile.add( ch->m_renderCost );
+				tracer.record( m_workerNum,
+					RenderTracer::EffectChannelJob, start,
+							ch->m_traceName );
+			}
+			break;
+		default:
+			break;
+	}
+	m_statistics.workTime += timer.elapsed();
+}
+
+
+
+
+void MixerWorkerThread::run()
+{
+	RealtimeHelper::setupThread( m_workerNum );
+
+	int epoch = s_jobQueue.epoch();
+	while( m_quit == false )
+	{
+		NewPeriodCondition cond( m_quit, epoch );
+		waitFor( cond, RenderTracer::WaitForPeriod );
+		epoch = s_jobQueue.epoch();
+		if( m_quit == false )
+		{
+			processJobQueue();
+		}
+	}
+}
+
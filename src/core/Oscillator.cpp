@@ -29,6 +29,11 @@
 
 
 
+MM_POOL_DEFINITION( Oscillator, 4096 )
+
+
+
+
 Oscillator::Oscillator( const IntModel * _wave_shape_model,
 				const IntModel * _mod_algo_model,
 				const float & _freq,
@@ -0,0 +1,105 @@
+/*
+ * PlanarBuffer.cpp - audio buffer holding each channel in a separate block
+ *
+ * Copyright (c) 2014 Tobias Doerffel <tobydox/at/users.sourceforge.net>
+ *
+ * This file is part of Linux MultiMedia Studio - http://lmms.sourceforge.net
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <cstring>
+
+#include "PlanarBuffer.h"
+#include "MemoryHelper.h"
+#include "MixHelpers.h"
+
+
+PlanarBuffer::PlanarBuffer( ch_cnt_t _channels, fpp_t _frames ) :
+	m_channels( _channels ),
+	m_frames( _frames ),
+	m_stride( 0 ),
+	m_memory( NULL ),
+	m_data( NULL )
+{
+	allocate();
+}
+
+
+
+
+PlanarBuffer::~PlanarBuffer()
+{
+	MemoryHelper::alignedFree( m_memory );
+}
+
+
+
+
+void PlanarBuffer::resize( fpp_t _frames )
+{
+	if( _frames > m_frames )
+	{
+		MemoryHelper::alignedFree( m_memory );
+		m_frames = _frames;
+		allocate();
+	}
+}
+
+
+
+
+void PlanarBuffer::clear()
+{
+	memset( m_data, 0, m_channels * m_stride * sizeof( sample_t ) );
+}
+
+
+
+
+void PlanarBuffer::fromInterleaved( const sampleFrame * _src, fpp_t _frames )
+{
+	MixHelpers::deinterleave( _src, _frames, channel( 0 ), channel( 1 ) );
+}
+
+
+
+
+void PlanarBuffer::toInterleaved( sampleFrame * _dst, fpp_t _frames ) const
+{
+	MixHelpers::interleave( channel( 0 ), channel( 1 ), _frames, _dst );
+}
+
+
+
+
+void PlanarBuffer::allocate()
+{
+	const int samplesPerBlock = Alignment / sizeof( sample_t );
+	m_stride = ( ( m_frames + samplesPerBlock - 1 ) / samplesPerBlock ) *
+							samplesPerBlock;
+
+	// MemoryHelper only aligns to ALIGN_SIZE, so allocate some more and
+	// align on our own
+	m_memory = MemoryHelper::alignedMalloc( m_channels * m_stride *
+					sizeof( sample_t ) + Alignment );
+	m_data = reinterpret_cast<sample_t *>(
+			( reinterpret_cast<size_t>( m_memory ) + Alignment - 1 ) &
+						~( (size_t) Alignment - 1 ) );
+	clear();
+}
+
@@ -31,10 +31,8 @@
 
 #include "AudioFileWave.h"
 #include "AudioFileOgg.h"
+#include "RealtimeHelper.h"
 
-#ifdef LMMS_HAVE_SCHED_H
-#include <sched.h>
-#endif
 #include <QMutexLocker>
 
 FileEncodeDevice __fileEncodeDevices[] =
@@ -147,16 +145,8 @@ void ProjectRenderer::startProcessing()
 
 void ProjectRenderer::run()
 {
-#if 0
-#ifdef LMMS_BUILD_LINUX
-#ifdef LMMS_HAVE_SCHED_H
-	cpu_set_t mask;
-	CPU_ZERO( &mask );
-	CPU_SET( 0, &mask );
-	sched_setaffinity( 0, sizeof( mask ), &mask );
-#endif
-#endif
-#endif
+	// we're rendering periods here, so we act as last worker
+	RealtimeHelper::setupThread( engine::mixer()->numWorkers()-1 );
 
 
 	engine::getSong()->startExport();
@@ -181,6 +171,14 @@ void ProjectRenderer::run()
 
 	engine::getSong()->stopExport();
 
+	// audio device is deleted below, so report now when rendering from
+	// command line
+	if( !engine::hasGUI() )
+	{
+		printf( "%s\n", m_fileDev->statistics().summary().
+						toUtf8().constData() );
+	}
+
 	const QString f = m_fileDev->outputFile();
 
 	engine::mixer()->restoreAudioDevice();  // also deletes audio-dev
@@ -0,0 +1,237 @@
+/*
+ * RealtimeCommandQueue.cpp - changes of render state applied by render thread
+ *
+ * Copyright (c) 2014 Tobias Doerffel <tobydox/at/users.sourceforge.net>
+ *
+ * This file is part of Linux MultiMedia Studio - http://lmms.sourceforge.net
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <QtCore/QThread>
+
+#include "RealtimeCommandQueue.h"
+
+
+// used by sync()
+class NoOpCommand : public RealtimeCommand
+{
+public:
+	virtual void execute()
+	{
+	}
+
+} ;
+
+
+
+
+RealtimeCommandQueue::RealtimeCommandQueue() :
+	m_pending( NULL ),
+	m_executed( NULL ),
+	m_executedEvent(),
+	m_active( false ),
+	m_processingThread( NULL ),
+	m_lockingThread( NULL ),
+	m_mutex()
+{
+}
+
+
+
+
+RealtimeCommandQueue::~RealtimeCommandQueue()
+{
+	setActive( false );
+	collectGarbage();
+}
+
+
+
+
+void RealtimeCommandQueue::post( RealtimeCommand * _cmd )
+{
+	collectGarbage();
+
+	if( !m_active )
+	{
+		executeDirectly( _cmd );
+		return;
+	}
+
+	push( m_pending, _cmd );
+}
+
+
+
+
+void RealtimeCommandQueue::postAndWait( RealtimeCommand * _cmd )
+{
+	collectGarbage();
+
+	// render thread would wait for itself
+	if( !m_active || QThread::currentThread() == m_processingThread )
+	{
+		executeDirectly( _cmd );
+		return;
+	}
+
+	// render thread can't get to processing commands while we hold the
+	// mixer lock, so do it ourselves - commands posted before go first
+	if( QThread::currentThread() == m_lockingThread )
+	{
+		QMutexLocker lock( &m_mutex );
+		process();
+		_cmd->execute();
+		_cmd->finish();
+		delete _cmd;
+		return;
+	}
+
+	_cmd->m_waitedFor = true;
+	push( m_pending, _cmd );
+
+	while( !_cmd->m_executed )
+	{
+		const int key = m_executedEvent.prepareWait();
+		if( _cmd->m_executed )
+		{
+			m_executedEvent.cancelWait();
+			break;
+		}
+		if( !m_active )
+		{
+			// mixer stopped processing after we queued _cmd
+			m_executedEvent.cancelWait();
+			QMutexLocker lock( &m_mutex );
+			process();
+			continue;
+		}
+		m_executedEvent.wait( key );
+	}
+
+	_cmd->finish();
+	delete _cmd;
+}
+
+
+
+
+void RealtimeCommandQueue::sync()
+{
+	postAndWait( new NoOpCommand );
+}
+
+
+
+
+void RealtimeCommandQueue::process()
+{
+	RealtimeCommand * cmd = m_pending.fetchAndStoreOrdered( NULL );
+	if( cmd == NULL )
+	{
+		return;
+	}
+
+	// stack holds most recently posted command first
+	RealtimeCommand * ordered = NULL;
+	while( cmd != NULL )
+	{
+		RealtimeCommand * next = cmd->m_next;
+		cmd->m_next = ordered;
+		ordered = cmd;
+		cmd = next;
+	}
+
+	m_processingThread = QThread::currentThread();
+	while( ordered != NULL )
+	{
+		RealtimeCommand * next = ordered->m_next;
+		ordered->execute();
+		if( ordered->m_waitedFor )
+		{
+			// waiting thread deletes command as soon as it sees
+			// this flag, so don't touch it afterwards
+			ordered->m_executed = true;
+		}
+		else
+		{
+			push( m_executed, ordered );
+		}
+		ordered = next;
+	}
+	m_processingThread = NULL;
+
+	m_executedEvent.notifyAll();
+}
+
+
+
+
+void RealtimeCommandQueue::setActive( bool _active )
+{
+	if( _active )
+	{
+		m_active = true;
+		return;
+	}
+
+	m_active = false;
+	QMutexLocker lock( &m_mutex );
+	process();
+}
+
+
+
+
+void RealtimeCommandQueue::collectGarbage()
+{
+	RealtimeCommand * cmd = m_executed.fetchAndStoreOrdered( NULL );
+	while( cmd != NULL )
+	{
+		RealtimeCommand * next = cmd->m_next;
+		cmd->finish();
+		delete cmd;
+		cmd = next;
+	}
+}
+
+
+
+
+void RealtimeCommandQueue::push( AtomicPointer<RealtimeCommand> & _stack,
+							RealtimeCommand * _cmd )
+{
+	RealtimeCommand * head;
+	do
+	{
+		head = _stack;
+		_cmd->m_next = head;
+	} while( !_stack.testAndSetOrdered( head, _cmd ) );
+}
+
+
+
+
+void RealtimeCommandQueue::executeDirectly( RealtimeCommand * _cmd )
+{
+	QMutexLocker lock( &m_mutex );
+	_cmd->execute();
+	_cmd->finish();
+	delete _cmd;
+}
+
@@ -0,0 +1,221 @@
+/*
+ * RealtimeHelper.cpp - CPU affinity, scheduling and memory locking for
+ *                      threads taking part in rendering
+ *
+ * Copyright (c) 2014 Tobias Doerffel <tobydox/at/users.sourceforge.net>
+ *
+ * This file is part of Linux MultiMedia Studio - http://lmms.sourceforge.net
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+#include <cstdio>
+
+#include <QtCore/QStringList>
+
+#include "RealtimeHelper.h"
+#include "AllocationTracker.h"
+#include "config_mgr.h"
+#include "lmmsconfig.h"
+
+#ifdef LMMS_HAVE_SCHED_H
+#include <sched.h>
+#endif
+
+#ifdef LMMS_HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
+
+#ifdef LMMS_HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
+
+
+RealtimeHelper::Settings RealtimeHelper::s_settings;
+
+static const int PageSize = 4096;
+
+// amount of stack touched by each render thread when locking memory
+static const int StackPrefaultSize = 64 * 1024;
+
+
+
+void RealtimeHelper::loadSettings()
+{
+	configManager * c = configManager::inst();
+
+	if( parseCpuList( c->value( "realtime", "cpus" ),
+						&s_settings.cpus ) == false )
+	{
+		printf( "Notice: ignoring invalid CPU list in config file.\n" );
+		s_settings.cpus.clear();
+	}
+
+	s_settings.policy = parsePolicy( c->value( "realtime", "policy" ) );
+	if( s_settings.policy == Policy_Invalid )
+	{
+		printf( "Notice: ignoring invalid scheduling policy in "
+							"config file.\n" );
+		s_settings.policy = Policy_Default;
+	}
+
+	s_settings.priority = c->value( "realtime", "priority" ).toInt();
+	s_settings.lockMemory = c->value( "realtime", "lockmemory" ).toInt();
+}
+
+
+
+
+bool RealtimeHelper::parseCpuList( const QString & _list, QList<int> * _cpus )
+{
+	_cpus->clear();
+
+	const QStringList ranges = _list.split( ',', QString::SkipEmptyParts );
+	foreach( const QString & r, ranges )
+	{
+		const QStringList bounds = r.trimmed().split( '-' );
+		bool ok_first = false;
+		bool ok_last = false;
+		const int first = bounds.first().toInt( &ok_first );
+		const int last = bounds.last().toInt( &ok_last );
+		if( bounds.size() > 2 || !ok_first || !ok_last ||
+						first < 0 || last < first )
+		{
+			_cpus->clear();
+			return false;
+		}
+		for( int cpu = first; cpu <= last; ++cpu )
+		{
+			_cpus->push_back( cpu );
+		}
+	}
+
+	return true;
+}
+
+
+
+
+RealtimeHelper::SchedulingPolicies RealtimeHelper::parsePolicy(
+						const QString & _policy )
+{
+	const QString p = _policy.trimmed().toLower();
+	if( p.isEmpty() || p == "default" || p == "other" )
+	{
+		return Policy_Default;
+	}
+	else if( p == "fifo" )
+	{
+		return Policy_Fifo;
+	}
+	else if( p == "rr" )
+	{
+		return Policy_RoundRobin;
+	}
+	return Policy_Invalid;
+}
+
+
+
+
+void RealtimeHelper::setupThread( int _index )
+{
+	AllocationTracker::registerRenderThread();
+
+#ifdef LMMS_BUILD_LINUX
+#ifdef LMMS_HAVE_SCHED_H
+	if( !s_settings.cpus.isEmpty() )
+	{
+		cpu_set_t mask;
+		CPU_ZERO( &mask );
+		CPU_SET( s_settings.cpus[_index % s_settings.cpus.size()],
+									&mask );
+		if( sched_setaffinity( 0, sizeof( mask ), &mask ) == -1 )
+		{
+			printf( "Notice: could not set CPU affinity.\n" );
+		}
+	}
+
+#ifdef LMMS_HAVE_PTHREAD_H
+	if( s_settings.policy != Policy_Default )
+	{
+		const int policy = s_settings.policy == Policy_Fifo ?
+							SCHED_FIFO : SCHED_RR;
+		const int min = sched_get_priority_min( policy );
+		const int max = sched_get_priority_max( policy );
+
+		struct sched_param sparam;
+		sparam.sched_priority = s_settings.priority > 0 ?
+				qBound( min, s_settings.priority, max ) :
+							( min + max ) / 2;
+		if( pthread_setschedparam( pthread_self(), policy,
+							&sparam ) != 0 )
+		{
+			printf( "Notice: could not set realtime priority.\n" );
+		}
+	}
+#endif
+#endif
+#endif
+
+	if( s_settings.lockMemory )
+	{
+		// make sure the stack this thread is going to use is mapped
+		char stack[StackPrefaultSize];
+		prefault( stack, StackPrefaultSize );
+	}
+}
+
+
+
+
+void RealtimeHelper::lockMemory()
+{
+	if( s_settings.lockMemory == false )
+	{
+		return;
+	}
+
+#ifdef LMMS_HAVE_SYS_MMAN_H
+	if( mlockall( MCL_CURRENT | MCL_FUTURE ) == -1 )
+	{
+		printf( "Notice: could not lock memory.\n" );
+	}
+#endif
+}
+
+
+
+
+void RealtimeHelper::prefault( void * _buf, int _bytes )
+{
+	if( s_settings.lockMemory == false || _buf == NULL )
+	{
+		return;
+	}
+
+	volatile char * p = (volatile char *) _buf;
+	for( int i = 0; i < _bytes; i += PageSize )
+	{
+		p[i] = p[i];
+	}
+	if( _bytes > 0 )
+	{
+		p[_bytes-1] = p[_bytes-1];
+	}
+}
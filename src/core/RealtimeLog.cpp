@@ -0,0 +1,327 @@
+/*
+ * RealtimeLog.cpp - non-blocking logging for render threads
+ *
+ * Copyright (c) 2014 Tobias Doerffel <tobydox/at/users.sourceforge.net>
+ *
+ * This file is part of Linux MultiMedia Studio - http://lmms.sourceforge.net
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+#include <QtCore/QHash>
+#include <QtCore/QThread>
+
+#include "RealtimeLog.h"
+#include "atomic_int.h"
+
+
+// has to be a power of two
+static const int Capacity = 256;
+static const int MaxLength = 192;
+static const int MaxMessagesPerSecond = 5;
+
+
+// slots are used in turn - a slot with sequence == write position is free,
+// one with sequence == read position + 1 holds a message
+struct Slot
+{
+	AtomicInt sequence;
+	const char * site;
+	char text[MaxLength];
+} ;
+
+struct SiteStatistics
+{
+	SiteStatistics() :
+		total( 0 ),
+		printed( 0 ),
+		suppressed( 0 ),
+		suppressedTotal( 0 ),
+		second( 0 )
+	{
+	}
+
+	int total;
+	// messages printed and suppressed in current second
+	int printed;
+	int suppressed;
+	int suppressedTotal;
+	time_t second;
+} ;
+
+
+static Slot s_slots[Capacity];
+static AtomicInt s_writePos;
+static int s_readPos = 0;
+static AtomicInt s_dropped;
+static volatile bool s_running = false;
+
+// only accessed by thread draining the queue
+static FILE * s_output = NULL;
+static QHash<const char *, SiteStatistics> s_sites;
+
+
+
+class RealtimeLogWriter : public QThread
+{
+public:
+	RealtimeLogWriter() :
+		m_finished( false )
+	{
+	}
+
+	void finish()
+	{
+		m_finished = true;
+	}
+
+
+private:
+	virtual void run();
+
+	volatile bool m_finished;
+
+} ;
+
+static RealtimeLogWriter * s_writer = NULL;
+
+
+
+
+static bool pop( const char * * _site, char * _text )
+{
+	Slot & s = s_slots[s_readPos & ( Capacity-1 )];
+	if( s.sequence != s_readPos + 1 )
+	{
+		return false;
+	}
+	*_site = s.site;
+	memcpy( _text, s.text, MaxLength );
+	// hand slot back to writers for next round
+	s.sequence.fetchAndStoreOrdered( s_readPos + Capacity );
+	++s_readPos;
+	return true;
+}
+
+
+
+
+static void reportSuppressed( const char * _site, SiteStatistics & _s )
+{
+	if( _s.suppressed > 0 )
+	{
+		fprintf( s_output, "(%d more messages like \"%s\" suppressed)\n",
+							_s.suppressed, _site );
+		_s.suppressedTotal += _s.suppressed;
+		_s.suppressed = 0;
+	}
+}
+
+
+
+
+static void write( const char * _site, const char * _text )
+{
+	SiteStatistics & s = s_sites[_site];
+	++s.total;
+
+	const time_t now = time( NULL );
+	if( now != s.second )
+	{
+		reportSuppressed( _site, s );
+		s.second = now;
+		s.printed = 0;
+	}
+
+	if( s.printed < MaxMessagesPerSecond )
+	{
+		fprintf( s_output, "%s\n", _text );
+		++s.printed;
+	}
+	else
+	{
+		++s.suppressed;
+	}
+}
+
+
+
+
+static void drain()
+{
+	const char * site;
+	char text[MaxLength];
+	while( pop( &site, text ) )
+	{
+		write( site, text );
+	}
+
+	// don't keep suppressed messages of a site going quiet secret
+	// until it posts again
+	const time_t now = time( NULL );
+	for( QHash<const char *, SiteStatistics>::Iterator it =
+				s_sites.begin(); it != s_sites.end(); ++it )
+	{
+		if( it.value().second != now )
+		{
+			reportSuppressed( it.key(), it.value() );
+		}
+	}
+	fflush( s_output );
+}
+
+
+
+
+void RealtimeLogWriter::run()
+{
+	while( !m_finished )
+	{
+		drain();
+		msleep( 100 );
+	}
+}
+
+
+
+
+void RealtimeLog::post( const char * _format, ... )
+{
+	va_list args;
+	va_start( args, _format );
+
+	if( !s_running )
+	{
+		vfprintf( stderr, _format, args );
+		fprintf( stderr, "\n" );
+		va_end( args );
+		return;
+	}
+
+	int pos = s_writePos;
+	Slot * s;
+	while( true )
+	{
+		s = &s_slots[pos & ( Capacity-1 )];
+		const int diff = s->sequence - pos;
+		if( diff == 0 )
+		{
+			if( s_writePos.testAndSetOrdered( pos, pos+1 ) )
+			{
+				break;
+			}
+		}
+		else if( diff < 0 )
+		{
+			// slot still holds message from previous round, i.e.
+			// queue is full
+			s_dropped.fetchAndAddOrdered( 1 );
+			va_end( args );
+			return;
+		}
+		pos = s_writePos;
+	}
+
+	s->site = _format;
+	vsnprintf( s->text, MaxLength, _format, args );
+	va_end( args );
+
+	// publish message
+	s->sequence.fetchAndStoreOrdered( pos+1 );
+}
+
+
+
+
+void RealtimeLog::start( const QString & _file )
+{
+	if( s_running )
+	{
+		return;
+	}
+
+	s_output = stderr;
+	if( !_file.isEmpty() )
+	{
+		s_output = fopen( _file.toLocal8Bit().constData(), "a" );
+		if( s_output == NULL )
+		{
+			fprintf( stderr, "Could not open %s for logging, "
+						"using stderr instead.\n",
+					_file.toLocal8Bit().constData() );
+			s_output = stderr;
+		}
+	}
+
+	for( int i = 0; i < Capacity; ++i )
+	{
+		s_slots[i].sequence = i;
+	}
+	s_writePos = 0;
+	s_readPos = 0;
+
+	s_running = true;
+	s_writer = new RealtimeLogWriter;
+	s_writer->start( QThread::LowestPriority );
+}
+
+
+
+
+void RealtimeLog::stop()
+{
+	if( !s_running )
+	{
+		return;
+	}
+	s_running = false;
+
+	s_writer->finish();
+	s_writer->wait();
+	delete s_writer;
+	s_writer = NULL;
+
+	drain();
+	for( QHash<const char *, SiteStatistics>::Iterator it =
+				s_sites.begin(); it != s_sites.end(); ++it )
+	{
+		reportSuppressed( it.key(), it.value() );
+		if( it.value().suppressedTotal > 0 )
+		{
+			fprintf( s_output, "%d messages like \"%s\" in total\n",
+					it.value().total, it.key() );
+		}
+	}
+	if( s_dropped > 0 )
+	{
+		fprintf( s_output, "%d messages dropped because log queue "
+					"was full\n", (int) s_dropped );
+	}
+	s_sites.clear();
+
+	if( s_output != stderr )
+	{
+		fclose( s_output );
+	}
+	s_output = NULL;
+}
+
@@ -30,6 +30,7 @@
 
 #include "RemotePlugin.h"
 #include "Mixer.h"
+#include "MixHelpers.h"
 #include "engine.h"
 #include "config_mgr.h"
 
@@ -200,7 +201,12 @@ bool RemotePlugin::process( const sampleFrame * _in_buf,
 
 	if( _in_buf != NULL && inputs > 0 )
 	{
-		if( m_splitChannels )
+		if( m_splitChannels && inputs == DEFAULT_CHANNELS )
+		{
+			MixHelpers::deinterleave( _in_buf, frames, m_shm,
+							m_shm + frames );
+		}
+		else if( m_splitChannels )
 		{
 			for( ch_cnt_t ch = 0; ch < inputs; ++ch )
 			{
@@ -242,7 +248,13 @@ bool RemotePlugin::process( const sampleFrame * _in_buf,
 
 	const ch_cnt_t outputs = qMin<ch_cnt_t>( m_outputCount,
 							DEFAULT_CHANNELS );
-	if( m_splitChannels )
+	if( m_splitChannels && outputs == DEFAULT_CHANNELS )
+	{
+		MixHelpers::interleave( m_shm + m_inputCount * frames,
+					m_shm + ( m_inputCount+1 ) * frames,
+							frames, _out_buf );
+	}
+	else if( m_splitChannels )
 	{
 		for( ch_cnt_t ch = 0; ch < outputs; ++ch )
 		{
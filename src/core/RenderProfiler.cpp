@@ -0,0 +1,94 @@
+/*
+ * RenderProfiler.cpp - measure time spent rendering tracks, effects,
+ *                      FX channels and stages of a period
+ *
+ * Copyright (c) 2014 Tobias Doerffel <tobydox/at/users.sourceforge.net>
+ *
+ * This file is part of Linux MultiMedia Studio - http://lmms.sourceforge.net
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+#include <cstring>
+
+#include "RenderProfiler.h"
+
+
+
+RenderProfiler::RenderProfiler() :
+	m_periodTimer(),
+	m_stageTimer(),
+	m_sequence( 0 )
+{
+	memset( &m_current, 0, sizeof( m_current ) );
+	memset( &m_published, 0, sizeof( m_published ) );
+}
+
+
+
+
+void RenderProfiler::startPeriod()
+{
+	m_periodTimer.reset();
+	m_stageTimer.reset();
+}
+
+
+
+
+void RenderProfiler::finishStage( Stages _stage )
+{
+	m_current.stageTime[_stage] = m_stageTimer.elapsed();
+	m_stageTimer.reset();
+}
+
+
+
+
+void RenderProfiler::finishPeriod( int _periodLength )
+{
+	m_current.stageTime[Stage_Period] = m_periodTimer.elapsed();
+	m_current.periodLength = _periodLength;
+	++m_current.period;
+
+	// seqlock - readers retry while we're writing
+	m_sequence.fetchAndAddOrdered( 1 );
+	m_published = m_current;
+	m_sequence.fetchAndAddOrdered( 1 );
+}
+
+
+
+
+RenderProfiler::Snapshot RenderProfiler::snapshot() const
+{
+	Snapshot s;
+	while( true )
+	{
+		const int seq = m_sequence.fetchAndAddOrdered( 0 );
+		if( seq & 1 )
+		{
+			continue;
+		}
+		s = m_published;
+		if( m_sequence.fetchAndAddOrdered( 0 ) == seq )
+		{
+			return s;
+		}
+	}
+}
@@ -0,0 +1,243 @@
+/*
+ * RenderTracer.cpp - record timeline of render threads and write it as
+ *                    Chrome trace (JSON)
+ *
+ * Copyright (c) 2014 Tobias Doerffel <tobydox/at/users.sourceforge.net>
+ *
+ * This file is part of Linux MultiMedia Studio - http://lmms.sourceforge.net
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+
+#include <cstring>
+
+#include <QtCore/QFile>
+#include <QtCore/QTextStream>
+
+#include "RenderTracer.h"
+
+
+// events per lane - recording silently stops on lanes which are full
+static const int LaneCapacity = 1 << 17;
+
+
+static const char * eventNames[RenderTracer::NumEventTypes] =
+{
+	"PlayHandle", "AudioPortEffects", "EffectChannel",
+	"wait for jobs", "wait for period", "period",
+	"fifo write", "fifo read"
+} ;
+
+static const char * eventCategories[RenderTracer::NumEventTypes] =
+{
+	"job", "job", "job", "wait", "wait", "period", "handoff", "handoff"
+} ;
+
+
+
+RenderTracer::RenderTracer() :
+	m_lanes(),
+	m_freeNames(),
+	m_startTime( 0 ),
+	m_recording( false )
+{
+	for( int i = MaxNames-1; i >= 0; --i )
+	{
+		m_names[i][0] = 0;
+		m_freeNames.push_back( i );
+	}
+}
+
+
+
+
+RenderTracer::~RenderTracer()
+{
+	stop();
+	for( int i = 0; i < m_lanes.size(); ++i )
+	{
+		delete m_lanes[i];
+	}
+}
+
+
+
+
+void RenderTracer::start( int _lanes )
+{
+	stop();
+
+	// lanes are kept once allocated, so a render thread still writing
+	// its last event after stop() never touches freed memory
+	while( m_lanes.size() < _lanes )
+	{
+		Lane * l = new Lane;
+		l->events.resize( LaneCapacity );
+		m_lanes.push_back( l );
+	}
+	for( int i = 0; i < m_lanes.size(); ++i )
+	{
+		m_lanes[i]->count = 0;
+	}
+
+	m_startTime = now();
+	m_recording = true;
+}
+
+
+
+
+void RenderTracer::stop()
+{
+	m_recording = false;
+}
+
+
+
+
+void RenderTracer::addEvent( int _lane, EventTypes _type, qint64 _start,
+								int _name )
+{
+	if( _lane < 0 || _lane >= m_lanes.size() )
+	{
+		return;
+	}
+	Lane * l = m_lanes[_lane];
+	if( l->count >= LaneCapacity )
+	{
+		return;
+	}
+
+	Event & e = l->events[l->count];
+	e.start = _start - m_startTime;
+	e.duration = (int)( now() - _start );
+	e.type = _type;
+	if( _name >= 0 )
+	{
+		memcpy( e.name, m_names[_name], NameLength );
+	}
+	else
+	{
+		e.name[0] = 0;
+	}
+
+	++l->count;
+}
+
+
+
+
+int RenderTracer::addName( const QString & _name )
+{
+	if( m_freeNames.isEmpty() )
+	{
+		return -1;
+	}
+	const int id = m_freeNames.back();
+	m_freeNames.pop_back();
+	setName( id, _name );
+	return id;
+}
+
+
+
+
+void RenderTracer::setName( int _id, const QString & _name )
+{
+	if( _id < 0 )
+	{
+		return;
+	}
+	// store name ready to be written into trace file
+	char * n = m_names[_id];
+	int len = 0;
+	for( ; len < _name.length() && len < NameLength-1; ++len )
+	{
+		const char ch = _name.at( len ).toLatin1();
+		n[len] = ( ch == '"' || ch == '\\' || ch < ' ' ) ? '_' : ch;
+	}
+	n[len] = 0;
+}
+
+
+
+
+void RenderTracer::removeName( int _id )
+{
+	if( _id >= 0 )
+	{
+		m_names[_id][0] = 0;
+		m_freeNames.push_back( _id );
+	}
+}
+
+
+
+
+bool RenderTracer::save( const QString & _file ) const
+{
+	QFile f( _file );
+	if( !f.open( QFile::WriteOnly | QFile::Truncate ) )
+	{
+		return false;
+	}
+
+	QTextStream ts( &f );
+	ts << "{\"traceEvents\":[\n";
+
+	bool first = true;
+	for( int i = 0; i < m_lanes.size(); ++i )
+	{
+		QString laneName;
+		if( i == m_lanes.size()-1 )
+		{
+			laneName = "audio device";
+		}
+		else if( i == m_lanes.size()-2 )
+		{
+			laneName = "render thread";
+		}
+		else
+		{
+			laneName = QString( "worker %1" ).arg( i );
+		}
+		ts << ( first ? "" : ",\n" ) <<
+			"{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+			"\"tid\":" << i << ",\"args\":{\"name\":\"" <<
+							laneName << "\"}}";
+		first = false;
+
+		const Lane * l = m_lanes[i];
+		for( int j = 0; j < l->count; ++j )
+		{
+			const Event & e = l->events[j];
+			ts << ",\n{\"name\":\"" << eventNames[e.type];
+			if( e.name[0] )
+			{
+				ts << ": " << e.name;
+			}
+			ts << "\",\"cat\":\"" << eventCategories[e.type] <<
+				"\",\"ph\":\"X\",\"pid\":1,\"tid\":" << i <<
+				",\"ts\":" << e.start <<
+				",\"dur\":" << e.duration << "}";
+		}
+	}
+
+	ts << "\n]}\n";
+	return true;
+}
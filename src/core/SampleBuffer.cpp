@@ -59,11 +59,16 @@
 #include "endian_handling.h"
 #include "engine.h"
 #include "interpolation.h"
+#include "RealtimeLog.h"
 #include "templates.h"
 
 #include "FileDialog.h"
 
 
+// enough for playing samples 3 octaves above their base note without
+// reallocating fragment buffer
+static const f_cnt_t DefaultFragmentBufferSize = DEFAULT_BUFFER_SIZE * 8 + 64;
+
 SampleBuffer::SampleBuffer( const QString & _audio_file,
 							bool _is_base64_data ) :
 	m_audioFile( ( _is_base64_data == true ) ? "" : _audio_file ),
@@ -78,7 +83,9 @@ SampleBuffer::SampleBuffer( const QString & _audio_file,
 	m_amplification( 1.0f ),
 	m_reversed( false ),
 	m_frequency( BaseFreq ),
-	m_sampleRate( engine::mixer()->baseSampleRate() )
+	m_sampleRate( engine::mixer()->baseSampleRate() ),
+	m_fragmentBuffer( new sampleFrame[DefaultFragmentBufferSize] ),
+	m_fragmentBufferSize( DefaultFragmentBufferSize )
 {
 	if( _is_base64_data == true )
 	{
@@ -103,7 +110,9 @@ SampleBuffer::SampleBuffer( const sampleFrame * _data, const f_cnt_t _frames ) :
 	m_amplification( 1.0f ),
 	m_reversed( false ),
 	m_frequency( BaseFreq ),
-	m_sampleRate( engine::mixer()->baseSampleRate() )
+	m_sampleRate( engine::mixer()->baseSampleRate() ),
+	m_fragmentBuffer( new sampleFrame[DefaultFragmentBufferSize] ),
+	m_fragmentBufferSize( DefaultFragmentBufferSize )
 {
 	if( _frames > 0 )
 	{
@@ -130,7 +139,9 @@ SampleBuffer::SampleBuffer( const f_cnt_t _frames ) :
 	m_amplification( 1.0f ),
 	m_reversed( false ),
 	m_frequency( BaseFreq ),
-	m_sampleRate( engine::mixer()->baseSampleRate() )
+	m_sampleRate( engine::mixer()->baseSampleRate() ),
+	m_fragmentBuffer( new sampleFrame[DefaultFragmentBufferSize] ),
+	m_fragmentBufferSize( DefaultFragmentBufferSize )
 {
 	if( _frames > 0 )
 	{
@@ -148,6 +159,7 @@ SampleBuffer::~SampleBuffer()
 {
 	delete[] m_origData;
 	delete[] m_data;
+	delete[] m_fragmentBuffer;
 }
 
 
@@ -664,8 +676,6 @@ bool SampleBuffer::play( sampleFrame * _ab, handleState * _state,
 		}
 	}
 
-	sampleFrame * tmp = NULL;
-
 	// check whether we have to change pitch...
 	if( freq_factor != 1.0 || _state->m_varyingPitch )
 	{
@@ -675,7 +685,7 @@ bool SampleBuffer::play( sampleFrame * _ab, handleState * _state,
 		f_cnt_t fragment_size = (f_cnt_t)( _frames * freq_factor )
 								+ margin;
 		src_data.data_in = getSampleFragment( play_frame,
-					fragment_size, _looped, &tmp )[0];
+						fragment_size, _looped )[0];
 		src_data.data_out = _ab[0];
 		src_data.input_frames = fragment_size;
 		src_data.output_frames = _frames;
@@ -685,13 +695,14 @@ bool SampleBuffer::play( sampleFrame * _ab, handleState * _state,
 								&src_data );
 		if( error )
 		{
-			printf( "SampleBuffer: error while resampling: %s\n",
-							src_strerror( error ) );
+			RealtimeLog::post( "SampleBuffer: error while "
+				"resampling: %s", src_strerror( error ) );
 		}
 		if( src_data.output_frames_gen > _frames )
 		{
-			printf( "SampleBuffer: not enough frames: %ld / %d\n",
-					src_data.output_frames_gen, _frames );
+			RealtimeLog::post( "SampleBuffer: not enough frames: "
+					"%ld / %d", src_data.output_frames_gen,
+								_frames );
 		}
 		// Advance
 		play_frame += src_data.input_frames_used;
@@ -707,7 +718,7 @@ bool SampleBuffer::play( sampleFrame * _ab, handleState * _state,
 
 		// Generate output
 		memcpy( _ab,
-			getSampleFragment( play_frame, _frames, _looped, &tmp ),
+			getSampleFragment( play_frame, _frames, _looped ),
 						_frames * BYTES_PER_FRAME );
 		// Advance
 		play_frame += _frames;
@@ -717,8 +728,6 @@ bool SampleBuffer::play( sampleFrame * _ab, handleState * _state,
 		}
 	}
 
-	delete[] tmp;
-
 	_state->m_frameIndex = play_frame;
 
 	return true;
@@ -729,7 +738,7 @@ bool SampleBuffer::play( sampleFrame * _ab, handleState * _state,
 
 
 sampleFrame * SampleBuffer::getSampleFragment( f_cnt_t _start,
-		f_cnt_t _frames, bool _looped, sampleFrame * * _tmp ) const
+						f_cnt_t _frames, bool _looped )
 {
 	if( _looped )
 	{
@@ -746,17 +755,24 @@ sampleFrame * SampleBuffer::getSampleFragment( f_cnt_t _start,
 		}
 	}
 
-	*_tmp = new sampleFrame[_frames];
+	// only happens for extreme pitches
+	if( _frames > m_fragmentBufferSize )
+	{
+		delete[] m_fragmentBuffer;
+		m_fragmentBuffer = new sampleFrame[_frames];
+		m_fragmentBufferSize = _frames;
+	}
+	sampleFrame * tmp = m_fragmentBuffer;
 
 	if( _looped )
 	{
 		f_cnt_t copied = m_loopEndFrame - _start;
-		memcpy( *_tmp, m_data + _start, copied * BYTES_PER_FRAME );
+		memcpy( tmp, m_data + _start, copied * BYTES_PER_FRAME );
 		f_cnt_t loop_frames = m_loopEndFrame - m_loopStartFrame;
 		while( _frames - copied > 0 )
 		{
 			f_cnt_t todo = qMin( _frames - copied, loop_frames );
-			memcpy( *_tmp + copied, m_data + m_loopStartFrame,
+			memcpy( tmp + copied, m_data + m_loopStartFrame,
 						todo * BYTES_PER_FRAME );
 			copied += todo;
 		}
@@ -764,12 +780,12 @@ sampleFrame * SampleBuffer::getSampleFragment( f_cnt_t _start,
 	else
 	{
 		f_cnt_t available = m_endFrame - _start;
-		memcpy( *_tmp, m_data + _start, available * BYTES_PER_FRAME );
-		memset( *_tmp + available, 0, ( _frames - available ) *
+		memcpy( tmp, m_data + _start, available * BYTES_PER_FRAME );
+		memset( tmp + available, 0, ( _frames - available ) *
 							BYTES_PER_FRAME );
 	}
 
-	return *_tmp;
+	return tmp;
 }
 
 
@@ -1304,6 +1320,11 @@ QString SampleBuffer::tryToMakeAbsolute( const QString & _file )
 
 
 
+MM_POOL_DEFINITION( SampleBuffer::handleState, 1024 )
+
+
+
+
 SampleBuffer::handleState::handleState( bool _varying_pitch ) :
 	m_frameIndex( 0 ),
 	m_varyingPitch( _varying_pitch )
@@ -1315,7 +1336,8 @@ SampleBuffer::handleState::handleState( bool _varying_pitch ) :
 					SRC_LINEAR,
 					DEFAULT_CHANNELS, &error ) ) == NULL )
 	{
-		printf( "Error: src_new() failed in sample_buffer.cpp!\n" );
+		RealtimeLog::post( "Error: src_new() failed in "
+						"SampleBuffer::handleState" );
 	}
 }
 
@@ -32,6 +32,10 @@
 #include "SampleTrack.h"
 
 
+MM_POOL_DEFINITION( SamplePlayHandle, 256 )
+
+
+
 
 SamplePlayHandle::SamplePlayHandle( const QString& sampleFile ) :
 	playHandle( playHandle::SamplePlayHandle ),
@@ -50,13 +54,15 @@ SamplePlayHandle::SamplePlayHandle( const QString& sampleFile ) :
 
 
 
-SamplePlayHandle::SamplePlayHandle( SampleBuffer* sampleBuffer ) :
+SamplePlayHandle::SamplePlayHandle( SampleBuffer* sampleBuffer,
+						AudioPort * audioPort ) :
 	playHandle( playHandle::SamplePlayHandle ),
 	m_sampleBuffer( sharedObject::ref( sampleBuffer ) ),
 	m_doneMayReturnTrue( true ),
 	m_frame( 0 ),
-	m_audioPort( new AudioPort( "SamplePlayHandle", false ) ),
-	m_ownAudioPort( true ),
+	m_audioPort( audioPort != NULL ? audioPort :
+				new AudioPort( "SamplePlayHandle", false ) ),
+	m_ownAudioPort( audioPort == NULL ),
 	m_defaultVolumeModel( DefaultVolume, MinVolume, MaxVolume, 1 ),
 	m_volumeModel( &m_defaultVolumeModel ),
 	m_track( NULL ),
@@ -22,11 +22,15 @@
  *
  */
 
+#include <climits>
 #include <cstring>
 
 #include "AudioDevice.h"
 #include "config_mgr.h"
 #include "debug.h"
+#include "MicroTimer.h"
+#include "MixHelpers.h"
+#include "RealtimeLog.h"
 
 
 
@@ -80,12 +84,31 @@ void AudioDevice::processNextBuffer()
 fpp_t AudioDevice::getNextBuffer( surroundSampleFrame * _ab )
 {
 	fpp_t frames = mixer()->framesPerPeriod();
+	MicroTimer timer;
 	const surroundSampleFrame * b = mixer()->nextBuffer();
 	if( !b )
 	{
 		return 0;
 	}
 
+	// the driver asked for the period now, so it's due after its length
+	const int slack = (int)( frames * 1000000.0f /
+				mixer()->processingSampleRate() ) -
+							timer.elapsed();
+	m_statistics.periods.fetchAndAddOrdered( 1 );
+	if( slack < 0 )
+	{
+		m_statistics.latePeriods.fetchAndAddOrdered( 1 );
+	}
+	int minSlack = m_statistics.minSlack;
+	while( slack < minSlack &&
+		!m_statistics.minSlack.testAndSetOrdered( minSlack, slack ) )
+	{
+		minSlack = m_statistics.minSlack;
+	}
+	m_statistics.averageSlack = m_statistics.periods == 1 ? slack :
+			( m_statistics.averageSlack * 15 + slack ) / 16;
+
 	// make sure, no other thread is accessing device
 	lock();
 
@@ -105,17 +128,23 @@ fpp_t AudioDevice::getNextBuffer( surroundSampleFrame * _ab )
 	// release lock
 	unlock();
 
-	if( mixer()->hasFifoWriter() )
-	{
-		delete[] b;
-	}
-
 	return frames;
 }
 
 
 
 
+void AudioDevice::recordRenderTime( int _usecs, int _periodLength )
+{
+	const int bin = _periodLength > 0 ?
+			qMin<int>( _usecs * 10 / _periodLength,
+					Statistics::RenderTimeBins-1 ) : 0;
+	m_statistics.renderTime[bin].fetchAndAddOrdered( 1 );
+}
+
+
+
+
 void AudioDevice::stopProcessing()
 {
 	if( mixer()->hasFifoWriter() )
@@ -186,8 +215,8 @@ void AudioDevice::resample( const surroundSampleFrame * _src,
 	int error;
 	if( ( error = src_process( m_srcState, &m_srcData ) ) )
 	{
-		printf( "AudioDevice::resample(): error while resampling: %s\n",
-							src_strerror( error ) );
+		RealtimeLog::post( "AudioDevice::resample(): error while "
+				"resampling: %s", src_strerror( error ) );
 	}
 }
 
@@ -199,7 +228,22 @@ int AudioDevice::convertToS16( const surroundSampleFrame * _ab,
 								int_sample_t * _output_buffer,
 								const bool _convert_endian )
 {
-	if( _convert_endian )
+	if( channels() == SURROUND_CHANNELS )
+	{
+		// frames are interleaved the same way in both buffers
+		MixHelpers::convertToS16( _ab[0], _frames * channels(),
+						_master_gain, _output_buffer );
+		if( _convert_endian )
+		{
+			for( int i = 0; i < _frames * channels(); ++i )
+			{
+				const int_sample_t temp = _output_buffer[i];
+				_output_buffer[i] = ( temp & 0x00ff ) << 8 |
+							( temp & 0xff00 ) >> 8;
+			}
+		}
+	}
+	else if( _convert_endian )
 	{
 		int_sample_t temp;
 		for( fpp_t frame = 0; frame < _frames; ++frame )
@@ -252,3 +296,55 @@ bool AudioDevice::hqAudio() const
 }
 
 
+
+
+
+
+AudioDevice::Statistics::Statistics()
+{
+	reset();
+}
+
+
+
+
+void AudioDevice::Statistics::reset()
+{
+	periods = 0;
+	underruns = 0;
+	latePeriods = 0;
+	for( int i = 0; i < RenderTimeBins; ++i )
+	{
+		renderTime[i] = 0;
+	}
+	minSlack = INT_MAX;
+	averageSlack = 0;
+}
+
+
+
+
+QString AudioDevice::Statistics::summary() const
+{
+	QString s = QString( "periods: %1, underruns: %2, late periods: %3\n" ).
+				arg( periods ).arg( underruns ).arg( latePeriods );
+	if( periods > 0 )
+	{
+		s += QString( "slack: min %1 us, average %2 us\n" ).
+					arg( minSlack ).arg( averageSlack );
+	}
+
+	s += "render time (% of period):";
+	for( int i = 0; i < RenderTimeBins; ++i )
+	{
+		if( renderTime[i] > 0 )
+		{
+			s += i < RenderTimeBins-1 ?
+				QString( " %1-%2: %3" ).arg( i*10 ).
+					arg( i*10+10 ).arg( renderTime[i] ) :
+				QString( " >%1: %2" ).arg( i*10 ).
+							arg( renderTime[i] );
+		}
+	}
+	return s;
+}
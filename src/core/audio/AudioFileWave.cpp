@@ -39,7 +39,10 @@ AudioFileWave::AudioFileWave( const sample_rate_t _sample_rate,
 	AudioFileDevice( _sample_rate, _channels, _file, _use_vbr,
 			_nom_bitrate, _min_bitrate, _max_bitrate,
 								_depth, _mixer ),
-	m_sf( NULL )
+	m_sf( NULL ),
+	m_bufferFrames( 0 ),
+	m_floatBuffer( NULL ),
+	m_intBuffer( NULL )
 {
 	_success_ful = outputFileOpened() && startEncoding();
 }
@@ -50,6 +53,8 @@ AudioFileWave::AudioFileWave( const sample_rate_t _sample_rate,
 AudioFileWave::~AudioFileWave()
 {
 	finishEncoding();
+	delete[] m_floatBuffer;
+	delete[] m_intBuffer;
 }
 
 
@@ -77,6 +82,11 @@ bool AudioFileWave::startEncoding()
 #endif
 					SFM_WRITE, &m_si );
 	sf_set_string ( m_sf, SF_STR_SOFTWARE, "LMMS" );
+
+	// periods are resampled to sampleRate() before being written
+	reserveBuffer( qMax<fpp_t>( mixer()->framesPerPeriod(),
+				mixer()->framesPerPeriod() * sampleRate() /
+				mixer()->processingSampleRate() + 1 ) );
 	return true;
 }
 
@@ -87,29 +97,52 @@ void AudioFileWave::writeBuffer( const surroundSampleFrame * _ab,
 						const fpp_t _frames,
 						const float _master_gain )
 {
+	// only happens if sample rate was changed while exporting
+	reserveBuffer( _frames );
+
 	if( depth() == 32 )
 	{
-		float *  buf = new float[_frames*channels()];
 		for( fpp_t frame = 0; frame < _frames; ++frame )
 		{
 			for( ch_cnt_t chnl = 0; chnl < channels(); ++chnl )
 			{
-				buf[frame*channels()+chnl] = _ab[frame][chnl] *
-								_master_gain;
+				m_floatBuffer[frame*channels()+chnl] =
+					_ab[frame][chnl] * _master_gain;
 			}
 		}
-		sf_writef_float( m_sf, buf, _frames );
-		delete[] buf;
+		sf_writef_float( m_sf, m_floatBuffer, _frames );
 	}
 	else
 	{
-		int_sample_t * buf = new int_sample_t[_frames * channels()];
-		convertToS16( _ab, _frames, _master_gain, buf,
+		convertToS16( _ab, _frames, _master_gain, m_intBuffer,
 							!isLittleEndian() );
 
-		sf_writef_short( m_sf, buf, _frames );
-		delete[] buf;
+		sf_writef_short( m_sf, m_intBuffer, _frames );
+	}
+}
+
+
+
+
+void AudioFileWave::reserveBuffer( const fpp_t _frames )
+{
+	if( _frames <= m_bufferFrames )
+	{
+		return;
+	}
+	delete[] m_floatBuffer;
+	delete[] m_intBuffer;
+	m_floatBuffer = NULL;
+	m_intBuffer = NULL;
+	if( depth() == 32 )
+	{
+		m_floatBuffer = new float[_frames * channels()];
+	}
+	else
+	{
+		m_intBuffer = new int_sample_t[_frames * channels()];
 	}
+	m_bufferFrames = _frames;
 }
 
 
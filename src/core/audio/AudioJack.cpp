@@ -166,6 +166,8 @@ bool AudioJack::initJackClient()
 	// set shutdown-callback
 	jack_on_shutdown( m_client, shutdownCallback, this );
 
+	jack_set_xrun_callback( m_client, xrunCallback, this );
+
 
 
 	if( jack_get_sample_rate( m_client ) != sampleRate() )
@@ -430,6 +432,15 @@ void AudioJack::shutdownCallback( void * _udata )
 
 
 
+int AudioJack::xrunCallback( void * _udata )
+{
+	static_cast<AudioJack *>( _udata )->reportUnderrun();
+	return 0;
+}
+
+
+
+
 
 AudioJack::setupWidget::setupWidget( QWidget * _parent ) :
 	AudioDevice::setupWidget( AudioJack::name(), _parent )
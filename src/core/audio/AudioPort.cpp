@@ -35,9 +35,18 @@ AudioPort::AudioPort( const QString & _name, bool _has_effect_chain ) :
 				engine::mixer()->framesPerPeriod()] ),
 	m_extOutputEnabled( false ),
 	m_nextFxChannel( 0 ),
-	m_name( "unnamed port" ),
+	m_renderJob( -1 ),
+	m_hasOutput( false ),
+	m_nextFxInput( NULL ),
+	m_renderCost( 0 ),
+	m_profile(),
+	m_name( _name ),
+	m_traceName( -1 ),
 	m_effects( _has_effect_chain ? new EffectChain( NULL ) : NULL )
 {
+	engine::mixer()->lock();
+	m_traceName = engine::mixer()->tracer().addName( m_name );
+	engine::mixer()->unlock();
 	engine::mixer()->clearAudioBuffer( m_firstBuffer,
 				engine::mixer()->framesPerPeriod() );
 	engine::mixer()->clearAudioBuffer( m_secondBuffer,
@@ -53,6 +62,9 @@ AudioPort::~AudioPort()
 {
 	setExtOutputEnabled( false );
 	engine::mixer()->removeAudioPort( this );
+	engine::mixer()->lock();
+	engine::mixer()->tracer().removeName( m_traceName );
+	engine::mixer()->unlock();
 	delete[] m_firstBuffer;
 	delete[] m_secondBuffer;
 	delete m_effects;
@@ -100,7 +112,10 @@ void AudioPort::setExtOutputEnabled( bool _enabled )
 
 void AudioPort::setName( const QString & _name )
 {
+	engine::mixer()->lock();
 	m_name = _name;
+	engine::mixer()->tracer().setName( m_traceName, m_name );
+	engine::mixer()->unlock();
 	engine::mixer()->audioDev()->renamePort( this );
 }
 
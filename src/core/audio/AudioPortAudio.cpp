@@ -326,9 +326,12 @@ int AudioPortAudio::_process_callback(
 	void * _arg )
 {
 	Q_UNUSED(_timeInfo);
-	Q_UNUSED(_statusFlags);
 
 	AudioPortAudio * _this  = static_cast<AudioPortAudio *> (_arg);
+	if( _statusFlags & paOutputUnderflow )
+	{
+		_this->reportUnderrun();
+	}
 	return _this->process_callback( (const float*)_inputBuffer,
 		(float*)_outputBuffer, _framesPerBuffer );
 }
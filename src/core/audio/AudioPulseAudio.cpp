@@ -45,6 +45,14 @@ static void stream_write_callback(pa_stream *s, size_t length, void *userdata)
 
 
 
+static void stream_underflow_callback( pa_stream *, void * userdata )
+{
+	static_cast<AudioPulseAudio *>( userdata )->reportUnderrun();
+}
+
+
+
+
 AudioPulseAudio::AudioPulseAudio( bool & _success_ful, Mixer*  _mixer ) :
 	AudioDevice( tLimit<ch_cnt_t>(
 		configManager::inst()->value( "audiopa", "channels" ).toInt(),
@@ -168,6 +176,7 @@ static void context_state_callback(pa_context *c, void *userdata)
 			_this->m_s = pa_stream_new( c, "lmms", &_this->m_sampleSpec,  NULL);
 			pa_stream_set_state_callback( _this->m_s, stream_state_callback, _this );
 			pa_stream_set_write_callback( _this->m_s, stream_write_callback, _this );
+			pa_stream_set_underflow_callback( _this->m_s, stream_underflow_callback, _this );
 
 			pa_buffer_attr buffer_attr;
 
@@ -54,7 +54,7 @@ bbTrackContainer::~bbTrackContainer()
 
 
 
-bool bbTrackContainer::play( MidiTime _start, fpp_t _frames,
+bool bbTrackContainer::play( const MidiTime & _start, const MidiTime & _end,
 								f_cnt_t _offset, int _tco_num )
 {
 	bool played_a_note = false;
@@ -63,15 +63,26 @@ bool bbTrackContainer::play( MidiTime _start, fpp_t _frames,
 		return false;
 	}
 
-	_start = _start % ( lengthOfBB( _tco_num ) * MidiTime::ticksPerTact() );
+	const tick_t len = lengthOfBB( _tco_num ) * MidiTime::ticksPerTact();
+	const float frames_per_tick = engine::framesPerTick();
 
 	TrackList tl = tracks();
-	for( TrackList::iterator it = tl.begin(); it != tl.end(); ++it )
+	// beat/bassline is looped, so range has to be split where it wraps
+	// around
+	for( tick_t t = _start; t < _end; )
 	{
-		if( ( *it )->play( _start, _frames, _offset, _tco_num ) )
+		const tick_t start = t % len;
+		const tick_t ticks = qMin<tick_t>( _end - t, len - start );
+		for( TrackList::iterator it = tl.begin(); it != tl.end(); ++it )
 		{
-			played_a_note = true;
+			if( ( *it )->play( start, start + ticks, _offset,
+								_tco_num ) )
+			{
+				played_a_note = true;
+			}
 		}
+		_offset += MidiTime( ticks ).frames( frames_per_tick );
+		t += ticks;
 	}
 
 	return played_a_note;
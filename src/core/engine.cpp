@@ -27,6 +27,7 @@
 
 #include "engine.h"
 #include "AutomationEditor.h"
+#include "basic_filters.h"
 #include "bb_editor.h"
 #include "bb_track_container.h"
 #include "config_mgr.h"
@@ -37,12 +38,17 @@
 #include "ladspa_2_lmms.h"
 #include "MainWindow.h"
 #include "Mixer.h"
+#include "note_play_handle.h"
+#include "Oscillator.h"
 #include "pattern.h"
 #include "piano_roll.h"
 #include "preset_preview_play_handle.h"
 #include "ProjectJournal.h"
 #include "project_notes.h"
 #include "Plugin.h"
+#include "RealtimeLog.h"
+#include "SampleBuffer.h"
+#include "SamplePlayHandle.h"
 #include "song_editor.h"
 #include "song.h"
 
@@ -76,6 +82,11 @@ void engine::init( const bool _has_gui )
 
 	initPluginFileHandling();
 
+	RealtimeLog::start( configManager::inst()->value( "realtime",
+								"logfile" ) );
+
+	initMemoryPools();
+
 	s_projectJournal = new ProjectJournal;
 	s_mixer = new Mixer;
 	s_song = new song;
@@ -87,6 +98,7 @@ void engine::init( const bool _has_gui )
 	s_projectJournal->setJournalling( true );
 
 	s_mixer->initDevices();
+	s_mixer->createMetronome();
 
 	if( s_hasGUI )
 	{
@@ -130,6 +142,7 @@ void engine::destroy()
 	deleteHelper( &s_bbTrackContainer );
 	deleteHelper( &s_dummyTC );
 
+	s_mixer->destroyMetronome();
 	deleteHelper( &s_mixer );
 	deleteHelper( &s_fxMixer );
 
@@ -142,6 +155,8 @@ void engine::destroy()
 
 	deleteHelper( &s_song );
 
+	RealtimeLog::stop();
+
 	delete configManager::inst();
 }
 
@@ -168,6 +183,21 @@ void engine::updateFramesPerTick()
 
 
 
+void engine::initMemoryPools()
+{
+	// creating a pool allocates memory and takes a lock, so do it now
+	// instead of when render threads create the first object
+	notePlayHandle::pool();
+	notePlayHandle::BaseDetuning::pool();
+	Oscillator::pool();
+	SampleBuffer::handleState::pool();
+	SamplePlayHandle::pool();
+	basicFilters<>::pool();
+}
+
+
+
+
 void engine::initPluginFileHandling()
 {
 	Plugin::DescriptorList pluginDescriptors;
@@ -61,7 +61,10 @@
 #include "LmmsStyle.h"
 #include "ImportFilter.h"
 #include "MainWindow.h"
+#include "MemoryPool.h"
+#include "AllocationTracker.h"
 #include "ProjectRenderer.h"
+#include "RealtimeHelper.h"
 #include "mmp.h"
 #include "song.h"
 
@@ -94,6 +97,7 @@ int main( int argc, char * * argv )
 	bool fullscreen = true;
 	bool exit_after_import = false;
 	QString file_to_load, file_to_save, file_to_import, render_out;
+	QString trace_file;
 
 	for( int i = 1; i < argc; ++i )
 	{
@@ -124,6 +128,14 @@ int main( int argc, char * * argv )
 						ProjectRenderer::Depth_16Bit );
 	ProjectRenderer::ExportFileFormats eff = ProjectRenderer::WaveFile;
 
+	// realtime settings given on command line - override config file
+	QList<int> rt_cpus;
+	bool rt_cpus_given = false;
+	RealtimeHelper::SchedulingPolicies rt_policy =
+					RealtimeHelper::Policy_Invalid;
+	int rt_priority = -1;
+	bool rt_lock_memory = false;
+
 
 	for( int i = 1; i < argc; ++i )
 	{
@@ -167,6 +179,14 @@ int main( int argc, char * * argv )
 	"-x, --oversampling <value>	specify oversampling\n"
 	"				possible values: 1, 2, 4, 8\n"
 	"				default: 2\n"
+	"    --cpus <list>		pin render threads to given CPUs,\n"
+	"				e.g. 0,2-3\n"
+	"    --rt-policy <policy>	scheduling policy of render threads\n"
+	"				possible values: default, fifo, rr\n"
+	"    --rt-priority <priority>	realtime priority of render threads\n"
+	"    --lock-memory		lock memory and prefault audio buffers\n"
+	"    --trace <file>		record timeline of render threads while\n"
+	"				rendering and save it as Chrome trace\n"
 	"-u, --upgrade <in> [out]	upgrade file <in> and save as <out>\n"
 	"       standard out is used if no output file is specifed\n"
 	"-d, --dump <in>			dump XML of compressed file <in>\n"
@@ -325,6 +345,44 @@ int main( int argc, char * * argv )
 			}
 			++i;
 		}
+		else if( argc > i+1 && QString( argv[i] ) == "--cpus" )
+		{
+			if( RealtimeHelper::parseCpuList( QString( argv[i + 1] ),
+							&rt_cpus ) == false )
+			{
+				printf( "\nInvalid CPU list %s.\n\n"
+	"Try \"%s --help\" for more information.\n\n", argv[i + 1], argv[0] );
+				return( EXIT_FAILURE );
+			}
+			rt_cpus_given = true;
+			++i;
+		}
+		else if( argc > i+1 && QString( argv[i] ) == "--rt-policy" )
+		{
+			rt_policy = RealtimeHelper::parsePolicy(
+							QString( argv[i + 1] ) );
+			if( rt_policy == RealtimeHelper::Policy_Invalid )
+			{
+				printf( "\nInvalid scheduling policy %s.\n\n"
+	"Try \"%s --help\" for more information.\n\n", argv[i + 1], argv[0] );
+				return( EXIT_FAILURE );
+			}
+			++i;
+		}
+		else if( argc > i+1 && QString( argv[i] ) == "--rt-priority" )
+		{
+			rt_priority = QString( argv[i + 1] ).toInt();
+			++i;
+		}
+		else if( QString( argv[i] ) == "--lock-memory" )
+		{
+			rt_lock_memory = true;
+		}
+		else if( argc > i+1 && QString( argv[i] ) == "--trace" )
+		{
+			trace_file = QString( argv[i + 1] );
+			++i;
+		}
 		else if( argc > i &&
 				( QString( argv[i] ) == "--import" ) )
 		{
@@ -382,6 +440,25 @@ int main( int argc, char * * argv )
 
 	configManager::inst()->loadConfigFile();
 
+	RealtimeHelper::loadSettings();
+	RealtimeHelper::Settings & rts = RealtimeHelper::settings();
+	if( rt_cpus_given )
+	{
+		rts.cpus = rt_cpus;
+	}
+	if( rt_policy != RealtimeHelper::Policy_Invalid )
+	{
+		rts.policy = rt_policy;
+	}
+	if( rt_priority >= 0 )
+	{
+		rts.priority = rt_priority;
+	}
+	if( rt_lock_memory )
+	{
+		rts.lockMemory = true;
+	}
+
 	if( render_out.isEmpty() )
 	{
 		// init style and palette
@@ -481,11 +558,46 @@ int main( int argc, char * * argv )
 				SLOT( updateConsoleProgress() ) );
 		t->start( 200 );
 
+		if( !trace_file.isEmpty() )
+		{
+			engine::mixer()->startTracing();
+		}
+
 		// start now!
 		r->startProcessing();
 	}
 
 	const int ret = app->exec();
+
+	if( !render_out.isEmpty() && !trace_file.isEmpty() )
+	{
+		engine::mixer()->stopTracing();
+		if( !engine::mixer()->tracer().save( trace_file ) )
+		{
+			printf( "Could not write trace to %s\n",
+					trace_file.toUtf8().constData() );
+		}
+	}
+
+	if( !render_out.isEmpty() )
+	{
+		// report pools which were too small for this project
+		const MemoryPool::StatisticsList pools =
+						MemoryPool::allStatistics();
+		for( int i = 0; i < pools.size(); ++i )
+		{
+			if( pools[i].overflows > 0 )
+			{
+				printf( "%s pool exhausted %d times (capacity %d, "
+						"peak usage %d)\n",
+						pools[i].name, pools[i].overflows,
+						pools[i].capacity, pools[i].peak );
+			}
+		}
+	}
+
+	AllocationTracker::report();
+
 	delete app;
 	return( ret );
 }
@@ -34,6 +34,12 @@
 #include "song.h"
 
 
+MM_POOL_DEFINITION( notePlayHandle, 1024 )
+MM_POOL_DEFINITION( notePlayHandle::BaseDetuning, 1024 )
+
+
+
+
 notePlayHandle::BaseDetuning::BaseDetuning( DetuningHelper *detuning ) :
 	m_value( detuning ? detuning->automationPattern()->valueAt( 0 ) : 0 )
 {
@@ -78,7 +84,8 @@ notePlayHandle::notePlayHandle( InstrumentTrack * _it,
 	m_baseDetuning( NULL ),
 	m_songGlobalParentOffset( 0 ),
 	m_midiChannel( midiEventChannel >= 0 ? midiEventChannel : instrumentTrack()->midiPort()->realOutputChannel() ),
-	m_origin( origin )
+	m_origin( origin ),
+	m_voiceRegistered( false )
 {
 	if( isTopNote() )
 	{
@@ -140,6 +147,11 @@ notePlayHandle::~notePlayHandle()
 		m_instrumentTrack->m_processHandles.removeAll( this );
 	}
 
+	if( m_voiceRegistered )
+	{
+		m_instrumentTrack->m_voices.removeAll( this );
+	}
+
 	if( m_pluginData != NULL )
 	{
 		m_instrumentTrack->deleteNotePluginData( this );
@@ -346,6 +358,14 @@ bool notePlayHandle::isFromTrack( const track * _track ) const
 
 
 
+AudioPort * notePlayHandle::audioPort()
+{
+	return m_instrumentTrack->audioPort();
+}
+
+
+
+
 void notePlayHandle::noteOff( const f_cnt_t _s )
 {
 	if( m_released )
@@ -433,21 +453,16 @@ void notePlayHandle::mute()
 
 int notePlayHandle::index() const
 {
-	const PlayHandleList & playHandles =
-					engine::mixer()->playHandles();
+	const NotePlayHandleList & voices = m_instrumentTrack->m_voices;
 	int idx = 0;
-	for( PlayHandleList::ConstIterator it = playHandles.begin();
-						it != playHandles.end(); ++it )
+	for( NotePlayHandleList::ConstIterator it = voices.begin();
+						it != voices.end(); ++it )
 	{
-		const notePlayHandle * nph =
-				dynamic_cast<const notePlayHandle *>( *it );
-		if( nph == NULL ||
-			nph->m_instrumentTrack != m_instrumentTrack ||
-						nph->released() == true )
+		if( ( *it )->released() == true )
 		{
 			continue;
 		}
-		if( nph == this )
+		if( *it == this )
 		{
 			break;
 		}
@@ -459,21 +474,30 @@ int notePlayHandle::index() const
 
 
 
+void notePlayHandle::registerVoice()
+{
+	if( !m_voiceRegistered )
+	{
+		m_instrumentTrack->m_voices.push_back( this );
+		m_voiceRegistered = true;
+	}
+}
+
+
+
+
 ConstNotePlayHandleList notePlayHandle::nphsOfInstrumentTrack(
 				const InstrumentTrack * _it, bool _all_ph )
 {
-	const PlayHandleList & playHandles = engine::mixer()->playHandles();
+	const NotePlayHandleList & voices = _it->m_voices;
 	ConstNotePlayHandleList cnphv;
 
-	for( PlayHandleList::ConstIterator it = playHandles.begin();
-						it != playHandles.end(); ++it )
+	for( NotePlayHandleList::ConstIterator it = voices.begin();
+						it != voices.end(); ++it )
 	{
-		const notePlayHandle * nph =
-				dynamic_cast<const notePlayHandle *>( *it );
-		if( nph != NULL && nph->m_instrumentTrack == _it &&
-			( nph->released() == false || _all_ph == true ) )
+		if( ( *it )->released() == false || _all_ph == true )
 		{
-			cnphv.push_back( nph );
+			cnphv.push_back( *it );
 		}
 	}
 	return cnphv;
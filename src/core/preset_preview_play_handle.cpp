@@ -219,6 +219,14 @@ bool presetPreviewPlayHandle::isFromTrack( const track * _track ) const
 
 
 
+AudioPort * presetPreviewPlayHandle::audioPort()
+{
+	return s_previewTC->previewInstrumentTrack()->audioPort();
+}
+
+
+
+
 void presetPreviewPlayHandle::init()
 {
 	if( !s_previewTC )
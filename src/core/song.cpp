@@ -563,42 +563,49 @@ void song::processNextBuffer()
 			m_playPos[m_playMode].setCurrentFrame( current_frame );
 		}
 
-		f_cnt_t last_frames = (f_cnt_t)frames_per_tick -
-						(f_cnt_t) current_frame;
-		// skip last frame fraction
-		if( last_frames == 0 )
+		// tick k after current one starts ceil( k * frames_per_tick -
+		// current_frame ) frames from now, so current one only if
+		// we're not already into it - determine all ticks starting
+		// within rest of period
+		const tick_t cur_tick = m_playPos[m_playMode].getTicks();
+		const tick_t first_tick = current_frame < 1.0f ?
+							cur_tick : cur_tick + 1;
+		tick_t end_tick = cur_tick + 1 + static_cast<tick_t>(
+			( played_frames - 1 + current_frame ) /
+							frames_per_tick );
+
+		// stop at end of tact or loop - where to continue is decided
+		// when getting there, so play rest of period in next loop
+		tick_t max_tick = ( m_playPos[m_playMode].getTact() + 1 ) *
+						MidiTime::ticksPerTact();
+		if( check_loop && tl->loopEnd() > cur_tick )
 		{
-			++total_frames_played;
-			m_playPos[m_playMode].setCurrentFrame( current_frame
-								+ 1.0f );
-			continue;
+			max_tick = qMin<tick_t>( max_tick, tl->loopEnd() );
 		}
-		// do we have some samples left in this tick but these are
-		// less then samples we have to play?
-		if( last_frames < played_frames )
+		if( end_tick > max_tick )
 		{
-			// then set played_samples to remaining samples, the
-			// rest will be played in next loop
-			played_frames = last_frames;
+			end_tick = max_tick;
+			played_frames = static_cast<f_cnt_t>( ceilf(
+				( max_tick - cur_tick ) * frames_per_tick -
+							current_frame ) );
 		}
 
-		if( (f_cnt_t) current_frame == 0 )
+		// ask every track once for everything in range - even if no
+		// tick starts within it, automation changes continuously
+		const f_cnt_t offset = total_frames_played +
+			static_cast<f_cnt_t>( ceilf( ( first_tick - cur_tick ) *
+					frames_per_tick - current_frame ) );
+		if( m_playMode == Mode_PlaySong )
 		{
-			if( m_playMode == Mode_PlaySong )
-			{
-				m_globalAutomationTrack->play(
-						m_playPos[m_playMode],
-						played_frames,
-						total_frames_played, tco_num );
-			}
+			m_globalAutomationTrack->play( first_tick, end_tick,
+							offset, tco_num );
+		}
 
-			// loop through all tracks and play them
-			for( int i = 0; i < track_list.size(); ++i )
-			{
-				track_list[i]->play( m_playPos[m_playMode],
-						played_frames,
-						total_frames_played, tco_num );
-			}
+		// loop through all tracks and play them
+		for( int i = 0; i < track_list.size(); ++i )
+		{
+			track_list[i]->play( first_tick, end_tick, offset,
+								tco_num );
 		}
 
 		// update frame-counters
@@ -644,6 +651,10 @@ void song::playSong()
 		stop();
 	}
 
+	// changes made right before (e.g. when loading a project for
+	// exporting) might not have been compiled yet
+	updateTimelines();
+
 	m_playMode = Mode_PlaySong;
 	m_playing = true;
 	m_paused = false;
@@ -656,6 +667,18 @@ void song::playSong()
 
 
 
+void song::updateTimelines()
+{
+	TrackList tl = tracks();
+	for( TrackList::Iterator it = tl.begin(); it != tl.end(); ++it )
+	{
+		( *it )->updateTimeline();
+	}
+}
+
+
+
+
 void song::record()
 {
 	m_recording = true;
@@ -681,6 +704,7 @@ void song::playTrack( track * _trackToPlay )
 		stop();
 	}
 	m_trackToPlay = _trackToPlay;
+	m_trackToPlay->updateTimeline();
 
 	m_playMode = Mode_PlayTrack;
 	m_playing = true;
@@ -39,6 +39,7 @@
 
 #include <assert.h>
 #include <cstdio>
+#include <limits>
 
 #include <QtGui/QLayout>
 #include <QtGui/QMenu>
@@ -59,6 +60,7 @@
 #include "gui_templates.h"
 #include "InstrumentTrack.h"
 #include "MainWindow.h"
+#include "Mixer.h"
 #include "mmp.h"
 #include "pixmap_button.h"
 #include "ProjectJournal.h"
@@ -151,6 +153,10 @@ void trackContentObject::movePosition( const MidiTime & _pos )
 	{
 		addJournalEntry( JournalEntry( Move, m_startPosition - _pos ) );
 		m_startPosition = _pos;
+		if( getTrack() )
+		{
+			getTrack()->updateTCOIndex( this );
+		}
 		engine::getSong()->updateLength();
 	}
 	emit positionChanged();
@@ -172,6 +178,10 @@ void trackContentObject::changeLength( const MidiTime & _length )
 	{
 		addJournalEntry( JournalEntry( Resize, m_length - _length ) );
 		m_length = _length;
+		if( getTrack() )
+		{
+			getTrack()->updateTCOIndex( this );
+		}
 		engine::getSong()->updateLength();
 	}
 	emit lengthChanged();
@@ -1552,10 +1562,20 @@ track::track( TrackTypes _type, TrackContainer * _tc ) :
 	m_soloModel( false, this, tr( "Solo" ) ),
 					/*!< For controlling track soloing */
 	m_simpleSerializingMode( false ),
-	m_trackContentObjects()         /*!< The track content objects (segments) */
+	m_trackContentObjects(),        /*!< The track content objects (segments) */
+	m_tcoIndex(),
+	m_tcoMaxEnd(),
+	m_tcoTreeLeaves( 0 ),
+	m_timeline( new EventTimelineSlot ),
+	m_timelineOutdated( false ),
+	m_timelineVersion( 0 )
 {
 	m_trackContainer->addTrack( this );
 	m_height = -1;
+
+	// compile timeline in our thread, no matter who invalidated it
+	connect( this, SIGNAL( timelineOutdated() ),
+			this, SLOT( updateTimeline() ), Qt::QueuedConnection );
 }
 
 
@@ -1581,6 +1601,9 @@ track::~track()
 	}
 
 	m_trackContainer->removeTrack( this );
+
+	// commands replacing timeline might still be queued
+	m_timeline->deref();
 }
 
 
@@ -1788,6 +1811,10 @@ void track::loadSettings( const QDomElement & _this )
 trackContentObject * track::addTCO( trackContentObject * _tco )
 {
 	m_trackContentObjects.push_back( _tco );
+	tcoVector index = m_tcoIndex;
+	insertIntoTCOIndex( index, _tco );
+	setTCOIndex( index );
+	invalidateTimeline();
 
 	emit trackContentObjectAdded( _tco );
 
@@ -1809,6 +1836,28 @@ void track::removeTCO( trackContentObject * _tco )
 	if( it != m_trackContentObjects.end() )
 	{
 		m_trackContentObjects.erase( it );
+		tcoVector index = m_tcoIndex;
+		index.remove( index.indexOf( _tco ) );
+		setTCOIndex( index );
+
+		// current timeline refers to _tco which is about to be
+		// deleted, so replace it right now instead of at start of
+		// next period
+		m_timelineOutdated = false;
+		EventTimeline * tl = compileNewTimeline();
+		Mixer * mixer = engine::mixer();
+		// mixer is gone already when song is destroyed on shutdown
+		if( mixer )
+		{
+			mixer->lock();
+		}
+		tl = m_timeline->replace( tl );
+		if( mixer )
+		{
+			mixer->unlock();
+		}
+		delete tl;
+
 		if( engine::getSong() )
 		{
 			engine::getSong()->updateLength();
@@ -1820,6 +1869,151 @@ void track::removeTCO( trackContentObject * _tco )
 
 
 
+/*! \brief Move a trackContentObject to its new place in the TCO index
+ *
+ *  Called whenever the position or length of a trackContentObject of
+ *  this track changed.
+ *
+ *  \param _tco The trackContentObject which changed.
+ */
+void track::updateTCOIndex( trackContentObject * _tco )
+{
+	const int i = m_tcoIndex.indexOf( _tco );
+	if( i < 0 )
+	{
+		return;
+	}
+	tcoVector index = m_tcoIndex;
+	index.remove( i );
+	insertIntoTCOIndex( index, _tco );
+	setTCOIndex( index );
+	invalidateTimeline();
+}
+
+
+
+
+/*! \brief Return index of first TCO starting at or after given position
+ *
+ *  \param _tcos TCOs ordered by start position.
+ *  \param _pos The position to search for.
+ */
+static int firstTCOFrom( const track::tcoVector & _tcos, tick_t _pos )
+{
+	int lo = 0;
+	int hi = _tcos.size();
+	while( lo < hi )
+	{
+		const int mid = ( lo + hi ) / 2;
+		if( _tcos[mid]->startPosition() < _pos )
+		{
+			lo = mid + 1;
+		}
+		else
+		{
+			hi = mid;
+		}
+	}
+	return lo;
+}
+
+
+
+
+/*! \brief Insert a trackContentObject into a TCO index
+ *
+ *  TCOs starting at the same position keep the order they were inserted
+ *  in.
+ *
+ *  \param _index The TCO index to insert into.
+ *  \param _tco The trackContentObject to insert.
+ */
+void track::insertIntoTCOIndex( tcoVector & _index,
+					trackContentObject * _tco )
+{
+	_index.insert( firstTCOFrom( _index, _tco->startPosition() + 1 ),
+									_tco );
+}
+
+
+
+
+/*! \brief Make given TCO index the current one
+ *
+ *  Builds the segment tree over the new index - each node holds the
+ *  latest end position of all TCOs below it, so lookups can skip whole
+ *  subtrees of TCOs ending before a range. Index and tree are built
+ *  without holding any lock and then swapped in under the mixer lock,
+ *  as the render thread reads them in getTCOsInRange().
+ *
+ *  \param _index The new TCO index, receives the old one.
+ */
+void track::setTCOIndex( tcoVector & _index )
+{
+	int leaves = 1;
+	while( leaves < _index.size() )
+	{
+		leaves *= 2;
+	}
+	QVector<tick_t> maxEnd( 2 * leaves,
+				std::numeric_limits<tick_t>::min() );
+	for( int i = 0; i < _index.size(); ++i )
+	{
+		maxEnd[leaves + i] = _index[i]->endPosition();
+	}
+	for( int n = leaves - 1; n > 0; --n )
+	{
+		maxEnd[n] = qMax( maxEnd[2 * n], maxEnd[2 * n + 1] );
+	}
+
+	Mixer * mixer = engine::mixer();
+	// mixer is gone already when song is destroyed on shutdown
+	if( mixer )
+	{
+		mixer->lock();
+	}
+	qSwap( m_tcoIndex, _index );
+	qSwap( m_tcoMaxEnd, maxEnd );
+	m_tcoTreeLeaves = leaves;
+	if( mixer )
+	{
+		mixer->unlock();
+	}
+	// old index and tree get freed when leaving, outside of the lock
+}
+
+
+
+
+/*! \brief Append TCOs below a node of the segment tree ending in range
+ *
+ *  \param _tco_v The list to append the found trackContentObjects to.
+ *  \param _node The node to start at.
+ *  \param _first Index of first TCO below _node.
+ *  \param _last Index after last TCO below _node.
+ *  \param _start TCOs ending before this position are skipped.
+ *  \param _end_index TCOs at this index or later are skipped.
+ */
+void track::collectTCOs( tcoVector & _tco_v, int _node, int _first,
+			int _last, tick_t _start, int _end_index ) const
+{
+	if( _first >= _end_index || m_tcoMaxEnd[_node] < _start )
+	{
+		return;
+	}
+	if( _last - _first == 1 )
+	{
+		_tco_v.push_back( m_tcoIndex[_first] );
+		return;
+	}
+	const int mid = ( _first + _last ) / 2;
+	collectTCOs( _tco_v, 2 * _node, _first, mid, _start, _end_index );
+	collectTCOs( _tco_v, 2 * _node + 1, mid, _last, _start, _end_index );
+}
+
+
+
+
 /*! \brief Return the number of trackContentObjects we contain
  *
  *  \return the number of trackContentObjects we currently contain.
@@ -1887,12 +2081,13 @@ int track::getTCONum( trackContentObject * _tco )
 
 /*! \brief Retrieve a list of trackContentObjects that fall within a period.
  *
- *  Here we're interested in a range of trackContentObjects that fall
- *  completely within a given time period - their start must be no earlier
- *  than the given start time and their end must be no later than the given
- *  end time.
+ *  Here we're interested in a range of trackContentObjects that overlap
+ *  a given time period - their start must be no later than the given end
+ *  time and their end must be no earlier than the given start time.
  *
  *  We return the TCOs we find in order by time, earliest TCOs first.
+ *  Instead of scanning all TCOs we look them up in the TCO index and its
+ *  segment tree, which takes O(log n + k) for k TCOs found.
  *
  *  \param _tco_c The list to contain the found trackContentObjects.
  *  \param _start The MIDI start time of the range.
@@ -1901,35 +2096,95 @@ int track::getTCONum( trackContentObject * _tco )
 void track::getTCOsInRange( tcoVector & _tco_v, const MidiTime & _start,
 							const MidiTime & _end )
 {
-	for( tcoVector::iterator it_o = m_trackContentObjects.begin();
-				it_o != m_trackContentObjects.end(); ++it_o )
+	if( m_tcoIndex.isEmpty() )
 	{
-		trackContentObject * tco = ( *it_o );
-		int s = tco->startPosition();
-		int e = tco->endPosition();
-		if( ( s <= _end ) && ( e >= _start ) )
-		{
-			// ok, TCO is posated within given range
-			// now let's search according position for TCO in list
-			// 	-> list is ordered by TCO's position afterwards
-			bool inserted = false;
-			for( tcoVector::iterator it = _tco_v.begin();
-						it != _tco_v.end(); ++it )
-			{
-				if( ( *it )->startPosition() >= s )
-				{
-					_tco_v.insert( it, tco );
-					inserted = true;
-					break;
-				}
-			}
-			if( inserted == false )
-			{
-				// no TCOs found posated behind current TCO...
-				_tco_v.push_back( tco );
-			}
-		}
+		return;
+	}
+	// TCOs starting after _end are skipped by index, the ones ending
+	// before _start by the segment tree
+	collectTCOs( _tco_v, 1, 0, m_tcoTreeLeaves, _start,
+				firstTCOFrom( m_tcoIndex, _end + 1 ) );
+}
+
+
+
+
+// replaces timeline of a track at start of next period and frees the old
+// one afterwards
+class TimelineCommand : public RealtimeCommand
+{
+public:
+	TimelineCommand( EventTimelineSlot * _slot, EventTimeline * _timeline ) :
+		m_slot( _slot ),
+		m_timeline( _timeline )
+	{
+		m_slot->ref();
+	}
+
+	virtual ~TimelineCommand()
+	{
+		delete m_timeline;
+		m_slot->deref();
 	}
+
+	virtual void execute()
+	{
+		m_timeline = m_slot->replace( m_timeline );
+	}
+
+
+private:
+	EventTimelineSlot * m_slot;
+	EventTimeline * m_timeline;
+
+} ;
+
+
+
+
+/*! \brief Mark the timeline of this track as outdated
+ *
+ *  Compiling is deferred to our thread's event loop, so changing a lot of
+ *  notes at once only compiles the timeline once.  Can be called from any
+ *  thread.
+ */
+void track::invalidateTimeline()
+{
+	if( m_timelineOutdated.testAndSetOrdered( false, true ) )
+	{
+		emit timelineOutdated();
+	}
+}
+
+
+
+
+/*! \brief Compile the timeline again if it's outdated
+ *
+ *  The new timeline is swapped in by the render thread at the start of
+ *  the next period, so it never compiles or allocates anything itself.
+ */
+void track::updateTimeline()
+{
+	if( m_timelineOutdated.testAndSetOrdered( true, false ) )
+	{
+		engine::mixer()->commandQueue().post(
+			new TimelineCommand( m_timeline, compileNewTimeline() ) );
+	}
+}
+
+
+
+
+/*! \brief Compile events of all trackContentObjects into a new timeline
+ */
+EventTimeline * track::compileNewTimeline()
+{
+	EventTimeline * tl = new EventTimeline(
+			m_timelineVersion.fetchAndAddOrdered( 1 ) + 1 );
+	compileTimeline( *tl );
+	tl->finalize();
+	return tl;
 }
 
 
@@ -42,16 +42,17 @@
 #include "gui_templates.h"
 #include "tooltip.h"
 #include "pixmap_button.h"
+#include "RenderLoadMeter.h"
 
 
 
 class FxLine : public QWidget
 {
 public:
-	FxLine( QWidget * _parent, FxMixerView * _mv, QString & _name ) :
+	FxLine( QWidget * _parent, FxMixerView * _mv, FxChannel * _ch ) :
 		QWidget( _parent ),
 		m_mv( _mv ),
-		m_name( _name )
+		m_ch( _ch )
 	{
 		setFixedSize( 32, 232 );
 		setAttribute( Qt::WA_OpaquePaintEvent, true );
@@ -86,10 +87,10 @@ public:
 		p.setFont( pointSizeF( font(), 7.5f ) );
 
 		p.setPen( sh_color );
-		p.drawText( -91, 21, m_name );
+		p.drawText( -91, 21, m_ch->m_name );
 		
 		p.setPen( m_mv->currentFxLine() == this ? bt_color : te_color );
-		p.drawText( -90, 20, m_name );
+		p.drawText( -90, 20, m_ch->m_name );
 		
 	}
 
@@ -105,10 +106,10 @@ public:
 				FxMixerView::tr( "Rename FX channel" ),
 				FxMixerView::tr( "Enter the new name for this "
 							"FX channel" ),
-				QLineEdit::Normal, m_name, &ok );
+				QLineEdit::Normal, m_ch->m_name, &ok );
 		if( ok && !new_name.isEmpty() )
 		{
-			m_name = new_name;
+			m_ch->setName( new_name );
 			update();
 		}
 	}
@@ -116,7 +117,7 @@ public:
 
 private:
 	FxMixerView * m_mv;
-	QString & m_name;
+	FxChannel * m_ch;
 
 } ;
 
@@ -173,7 +174,7 @@ FxMixerView::FxMixerView() :
 		if( i == 0 )
 		{
 			cv->m_fxLine = new FxLine( NULL, this,
-						m->m_fxChannels[i]->m_name  );
+							m->m_fxChannels[i] );
 			ml->addWidget( cv->m_fxLine );
 			ml->addSpacing( 10 );
 		}
@@ -181,7 +182,7 @@ FxMixerView::FxMixerView() :
 		{
 			const int bank = (i-1) / 16;
 			cv->m_fxLine = new FxLine( NULL, this,
-						m->m_fxChannels[i]->m_name );
+							m->m_fxChannels[i] );
 			banks[bank]->addWidget( cv->m_fxLine );
 		}
 		LcdWidget* l = new LcdWidget( 2, cv->m_fxLine );
@@ -189,6 +190,12 @@ FxMixerView::FxMixerView() :
 		l->move( 3, 4 );
 		l->setMarginWidth( 1 );
 
+		// time spent on this channel and everything routed to it
+		RenderLoadMeter * rlm = new RenderLoadMeter( cv->m_fxLine,
+					&m->m_fxChannels[i]->m_profile,
+					&m->m_fxChannels[i]->m_inputProfile );
+		rlm->move( 25, 30 );
+
 
 		cv->m_fader = new fader( &m->m_fxChannels[i]->m_volumeModel,
 						tr( "FX Fader %1" ).arg( i ),
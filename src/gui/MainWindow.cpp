@@ -287,6 +287,12 @@ void MainWindow::finalize( void )
 	edit_menu->addAction( embed::getIconPixmap( "setup_general" ),
 					tr( "Settings" ),
 					this, SLOT( showSettingsDialog() ) );
+	edit_menu->addSeparator();
+	QAction * trace_action = edit_menu->addAction(
+					tr( "Record render trace" ) );
+	trace_action->setCheckable( true );
+	connect( trace_action, SIGNAL( toggled( bool ) ),
+				this, SLOT( toggleRenderTrace( bool ) ) );
 
 
 	m_toolsMenu = new QMenu( this );
@@ -798,6 +804,35 @@ bool MainWindow::saveProjectAsNewVersion( void )
 
 
 
+void MainWindow::toggleRenderTrace( bool _on )
+{
+	if( _on )
+	{
+		engine::mixer()->startTracing();
+		return;
+	}
+
+	engine::mixer()->stopTracing();
+
+	FileDialog sfd( this, tr( "Save render trace" ), "",
+				tr( "Chrome trace (*.json)" ) );
+	sfd.setAcceptMode( FileDialog::AcceptSave );
+	sfd.setDirectory( configManager::inst()->workingDir() );
+	if( sfd.exec() == FileDialog::Accepted &&
+		!sfd.selectedFiles().isEmpty() && sfd.selectedFiles()[0] != "" )
+	{
+		if( !engine::mixer()->tracer().save( sfd.selectedFiles()[0] ) )
+		{
+			QMessageBox::critical( this, tr( "Could not save trace" ),
+				tr( "Could not write file %1." ).arg(
+						sfd.selectedFiles()[0] ) );
+		}
+	}
+}
+
+
+
+
 void MainWindow::showSettingsDialog( void )
 {
 	setupDialog sd;
@@ -1054,6 +1054,8 @@ void pianoRoll::shiftPos( int amount ) //shift notes pos by amount
 			( *it )->setPos( ( *it )->pos() + amount );
 		}
 	}
+	// keep notes ordered (and timeline of track up to date)
+	m_pattern->rearrangeAllNotes();
 	
 	// we modified the song
 	update();
@@ -2632,6 +2634,14 @@ void pianoRoll::dragNotes( int x, int y, bool alt, bool shift )
 		}
 		++it;
 	}
+
+	// positions changed, so keep notes ordered and timeline of track up
+	// to date while dragging
+	if( m_action == ActionMoveNote ||
+				( m_action == ActionResizeNote && shift ) )
+	{
+		m_pattern->rearrangeAllNotes();
+	}
 	
 	m_pattern->dataChanged();
 	engine::getSong()->setModified();
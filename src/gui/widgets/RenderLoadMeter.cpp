@@ -0,0 +1,112 @@
+/*
+ * RenderLoadMeter.cpp - widget showing share of a period spent rendering a
+ *                       track or FX channel
+ *
+ * Copyright (c) 2014 Tobias Doerffel <tobydox/at/users.sourceforge.net>
+ *
+ * This file is part of Linux MultiMedia Studio - http://lmms.sourceforge.net
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program (see COPYING); if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301 USA.
+ *
+ */
+
+#include <QtGui/QPainter>
+
+#include "RenderLoadMeter.h"
+#include "MainWindow.h"
+#include "Mixer.h"
+#include "engine.h"
+#include "tooltip.h"
+
+
+
+RenderLoadMeter::RenderLoadMeter( QWidget * _parent,
+					const ProfilerNode * _node,
+					const ProfilerNode * _secondNode ) :
+	QWidget( _parent ),
+	m_node( _node ),
+	m_secondNode( _secondNode ),
+	m_load( 0.0f ),
+	m_lastPeriod( -1 )
+{
+	setAttribute( Qt::WA_OpaquePaintEvent, true );
+	setFixedSize( 4, 24 );
+
+	connect( engine::mainWindow(), SIGNAL( periodicUpdate() ),
+					this, SLOT( updateLoad() ) );
+}
+
+
+
+
+RenderLoadMeter::~RenderLoadMeter()
+{
+}
+
+
+
+
+void RenderLoadMeter::paintEvent( QPaintEvent * )
+{
+	QPainter p( this );
+	p.fillRect( rect(), QColor( 0, 0, 0 ) );
+
+	const int h = qMin<int>( height(), (int)( m_load * height() / 100 ) );
+	if( h > 0 )
+	{
+		// green for light load, turning red when getting near to
+		// length of a period
+		const int r = qMin<int>( 255, (int)( m_load * 255 / 50 ) );
+		const int g = qMin<int>( 255, (int)( ( 100 - m_load ) *
+								255 / 50 ) );
+		p.fillRect( 0, height() - h, width(), h,
+					QColor( r, qMax( 0, g ), 0 ) );
+	}
+}
+
+
+
+
+void RenderLoadMeter::updateLoad()
+{
+	const RenderProfiler::Snapshot s =
+				engine::mixer()->profiler().snapshot();
+	if( s.period == m_lastPeriod || s.periodLength <= 0 )
+	{
+		return;
+	}
+	m_lastPeriod = s.period;
+
+	int t = m_node->time();
+	if( m_secondNode != NULL )
+	{
+		t += m_secondNode->time();
+	}
+
+	const float load = 100.0f * t / s.periodLength;
+	const float oldLoad = m_load;
+	m_load = qMax( load, m_load * 0.9f );
+
+	if( (int) oldLoad != (int) m_load )
+	{
+		toolTip::add( this, tr( "CPU: %1%" ).arg( (int) m_load ) );
+		update();
+	}
+}
+
+
+
+#include "moc_RenderLoadMeter.cxx"
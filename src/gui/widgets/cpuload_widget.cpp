@@ -27,9 +27,11 @@
 #include <QtGui/QPainter>
 
 #include "cpuload_widget.h"
+#include "AudioDevice.h"
 #include "embed.h"
 #include "engine.h"
 #include "Mixer.h"
+#include "tooltip.h"
 
 
 cpuloadWidget::cpuloadWidget( QWidget * _parent ) :
@@ -39,6 +41,7 @@ cpuloadWidget::cpuloadWidget( QWidget * _parent ) :
 	m_background( embed::getIconPixmap( "cpuload_bg" ) ),
 	m_leds( embed::getIconPixmap( "cpuload_leds" ) ),
 	m_changed( true ),
+	m_statisticsAge( 0 ),
 	m_updateTimer()
 {
 	setAttribute( Qt::WA_OpaquePaintEvent, true );
@@ -99,6 +102,17 @@ void cpuloadWidget::updateCpuLoad()
 		m_changed = true;
 		update();
 	}
+
+	// show underruns etc. as tooltip, updated once a second
+	if( ++m_statisticsAge >= 10 )
+	{
+		m_statisticsAge = 0;
+		const AudioDevice * dev = engine::mixer()->audioDev();
+		if( dev != NULL )
+		{
+			toolTip::add( this, dev->statistics().summary() );
+		}
+	}
 }
 
 
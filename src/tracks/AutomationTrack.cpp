@@ -24,9 +24,12 @@
  *
  */
 
+#include <climits>
+
 #include "AutomationTrack.h"
 #include "AutomationPattern.h"
 #include "engine.h"
+#include "Mixer.h"
 #include "embed.h"
 #include "ProjectJournal.h"
 #include "string_pair_drag.h"
@@ -35,7 +38,9 @@
 
 
 AutomationTrack::AutomationTrack( TrackContainer* tc, bool _hidden ) :
-	track( _hidden ? HiddenAutomationTrack : track::AutomationTrack, tc )
+	track( _hidden ? HiddenAutomationTrack : track::AutomationTrack, tc ),
+	m_values( engine::mixer()->framesPerPeriod() ),
+	m_lastPeriod( -1 )
 {
 	setName( tr( "Automation track" ) );
 }
@@ -50,7 +55,7 @@ AutomationTrack::~AutomationTrack()
 
 
 
-bool AutomationTrack::play( const MidiTime & _start, const fpp_t _frames,
+bool AutomationTrack::play( const MidiTime & _start, const MidiTime & _end,
 							const f_cnt_t _frame_base, int _tco_num )
 {
 	if( isMuted() )
@@ -58,6 +63,16 @@ bool AutomationTrack::play( const MidiTime & _start, const fpp_t _frames,
 		return false;
 	}
 
+	// frames of period before _frame_base still belong to tick before
+	// _start when we're called first time in this period, otherwise they
+	// have been handled already
+	f_cnt_t from = qMax<f_cnt_t>( _frame_base, 0 );
+	if( m_lastPeriod != AutomatableModel::period() )
+	{
+		m_lastPeriod = AutomatableModel::period();
+		from = 0;
+	}
+
 	tcoVector tcos;
 	if( _tco_num >= 0 )
 	{
@@ -66,8 +81,7 @@ bool AutomationTrack::play( const MidiTime & _start, const fpp_t _frames,
 	}
 	else
 	{
-		getTCOsInRange( tcos, _start, _start + static_cast<int>(
-					_frames / engine::framesPerTick()) );
+		getTCOsInRange( tcos, _start - 1, _end - 1 );
 	}
 
 	for( tcoVector::iterator it = tcos.begin(); it != tcos.end(); ++it )
@@ -77,12 +91,18 @@ bool AutomationTrack::play( const MidiTime & _start, const fpp_t _frames,
 		{
 			continue;
 		}
-		MidiTime cur_start = _start;
-		if( _tco_num < 0 )
+		if( _tco_num >= 0 )
+		{
+			p->processPeriod( _start, _frame_base, from, INT_MAX,
+							m_values.data() );
+		}
+		else
 		{
-			cur_start -= p->startPosition();
+			p->processPeriod( _start - p->startPosition(),
+					_frame_base, from, p->endPosition() -
+							p->startPosition(),
+							m_values.data() );
 		}
-		p->processMidiTime( cur_start );
 	}
 	return false;
 }
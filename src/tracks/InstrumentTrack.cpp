@@ -69,6 +69,7 @@
 #include "note_play_handle.h"
 #include "pattern.h"
 #include "PluginView.h"
+#include "RenderLoadMeter.h"
 #include "SamplePlayHandle.h"
 #include "song.h"
 #include "string_pair_drag.h"
@@ -164,7 +165,15 @@ void InstrumentTrack::processAudioBuffer( sampleFrame * _buf,
 	// now
 	m_audioPort.effects()->startRunning();
 
-	float v_scale = (float) getVolume() / DefaultVolume;
+	const f_cnt_t offset = ( _n != NULL ) ? _n->offset() : 0;
+	const fpp_t frames = ( _n != NULL ) ?
+		qMin<f_cnt_t>( _n->framesLeftForCurrentPeriod(), _frames ) :
+								_frames;
+
+	// if volume is automated within this period, apply it per frame
+	// instead of using one value for the whole buffer
+	const float * vol = m_volumeModel.valueBuffer();
+	float v_scale = vol ? 1.0f : (float) getVolume() / DefaultVolume;
 
 	// instruments using instrument-play-handles will call this method
 	// without any knowledge about notes, so they pass NULL for _n, which
@@ -180,6 +189,17 @@ void InstrumentTrack::processAudioBuffer( sampleFrame * _buf,
 					m_instrument->isMidiBased() )
 		{
 			v_scale = 1;
+			vol = NULL;
+		}
+	}
+
+	if( vol != NULL )
+	{
+		for( fpp_t f = 0; f < frames; ++f )
+		{
+			const float v = vol[offset + f] / DefaultVolume;
+			_buf[f][0] *= v;
+			_buf[f][1] *= v;
 		}
 	}
 
@@ -191,10 +211,7 @@ void InstrumentTrack::processAudioBuffer( sampleFrame * _buf,
 		panning += _n->getPanning();
 		panning = tLimit<int>( panning, PanningLeft, PanningRight );
 	}
-	engine::mixer()->bufferToPort( _buf, ( _n != NULL ) ?
-		qMin<f_cnt_t>(_n->framesLeftForCurrentPeriod(), _frames ) :
-								_frames,
-			( _n != NULL ) ? _n->offset() : 0,
+	engine::mixer()->bufferToPort( _buf, frames, offset,
 			panningToVolumeVector( panning,	v_scale ),
 								&m_audioPort );
 }
@@ -543,132 +560,183 @@ void InstrumentTrack::removeMidiPortNode( multimediaProject & _mmp )
 
 
 
-bool InstrumentTrack::play( const MidiTime & _start, const fpp_t _frames,
+bool InstrumentTrack::play( const MidiTime & _start, const MidiTime & _end,
 							const f_cnt_t _offset, int _tco_num )
 {
+	// Handle automation: detuning - only value at last tick of range
+	// matters as it's rendered afterwards
+	for( NotePlayHandleList::Iterator it = m_processHandles.begin();
+					it != m_processHandles.end(); ++it )
+	{
+		( *it )->processMidiTime( _end - 1 );
+	}
+
 	const float frames_per_tick = engine::framesPerTick();
+	const bool play_frozen = !engine::getSong()->isExporting();
+	bool played_a_note = false;	// will be return variable
 
-	tcoVector tcos;
-	bbTrack * bb_track = NULL;
-	if( _tco_num >= 0 )
+	if( _tco_num < 0 )
 	{
-		trackContentObject * tco = getTCO( _tco_num );
-		tcos.push_back( tco );
-		bb_track = bbTrack::findBBTrack( _tco_num );
+		// playing song - everything to start within range has been
+		// compiled into our timeline already; notes might have been
+		// removed since, until new timeline is swapped in
+		const EventTimeline & tl = timeline();
+		const EventTimeline::EventVector & events = tl.events();
+		for( int i = tl.firstEventFrom( _start );
+				i < events.size() && events[i].pos < _end; ++i )
+		{
+			pattern * p = static_cast<pattern *>( events[i].tco );
+			if( p->isMuted() )
+			{
+				continue;
+			}
+			const f_cnt_t offset = _offset +
+				MidiTime( events[i].pos - _start ).frames(
+							frames_per_tick );
+			if( p->isFrozen() && play_frozen )
+			{
+				if( events[i].n == NULL )
+				{
+					playFrozenPattern( p, NULL, offset );
+					played_a_note = true;
+				}
+			}
+			else if( events[i].n != NULL )
+			{
+				// adding notes shifts the ones after them, so
+				// look note up again if it's not where it was
+				const NoteVector & notes = p->notes();
+				int idx = events[i].index;
+				if( idx >= notes.size() || notes[idx] != events[i].n )
+				{
+					idx = notes.indexOf( events[i].n );
+				}
+				if( idx >= 0 &&
+					startNote( p, idx, NULL, offset, true ) )
+				{
+					played_a_note = true;
+				}
+			}
+		}
+		return played_a_note;
 	}
-	else
+
+	pattern * p = dynamic_cast<pattern *>( getTCO( _tco_num ) );
+	// everything which is not a pattern or muted won't be played
+	if( p == NULL || p->isMuted() )
 	{
-		getTCOsInRange( tcos, _start, _start + static_cast<int>(
-					_frames / frames_per_tick ) );
+		return false;
 	}
+	bbTrack * bb_track = bbTrack::findBBTrack( _tco_num );
 
-	// Handle automation: detuning
-	for( NotePlayHandleList::Iterator it = m_processHandles.begin();
-					it != m_processHandles.end(); ++it )
+	if( p->isFrozen() && play_frozen )
 	{
-		( *it )->processMidiTime( _start );
+		if( _start > 0 )
+		{
+			return false;
+		}
+		playFrozenPattern( p, bb_track, _offset );
+		return true;
 	}
 
-	if ( tcos.size() == 0 )
+	// skip notes posated before range - pattern remembers where we were
+	// last time, so only notes played meanwhile are skipped
+	const NoteVector & notes = p->notes();
+	for( int i = p->firstNoteFrom( _start );
+				i < notes.size() && notes[i]->pos() < _end; ++i )
 	{
-		return false;
+		const f_cnt_t offset = _offset + MidiTime( notes[i]->pos() -
+					_start ).frames( frames_per_tick );
+		if( startNote( p, i, bb_track, offset, false ) )
+		{
+			played_a_note = true;
+		}
 	}
+	return played_a_note;
+}
+
+
 
-	bool played_a_note = false;	// will be return variable
 
-	for( tcoVector::Iterator it = tcos.begin(); it != tcos.end(); ++it )
+void InstrumentTrack::compileTimeline( EventTimeline & _timeline )
+{
+	const tcoVector & tcos = getTCOs();
+	for( tcoVector::ConstIterator it = tcos.begin(); it != tcos.end(); ++it )
 	{
 		pattern * p = dynamic_cast<pattern *>( *it );
-		// everything which is not a pattern or muted won't be played
-		if( p == NULL || ( *it )->isMuted() )
+		if( p == NULL )
 		{
 			continue;
 		}
-		MidiTime cur_start = _start;
-		if( _tco_num < 0 )
+		// muting and freezing is checked when playing, so we don't
+		// have to compile again when it changes
+		const tick_t start = p->startPosition();
+		_timeline.addEvent( start, p );
+
+		const NoteVector & notes = p->notes();
+		for( int i = 0; i < notes.size() &&
+			start + notes[i]->pos() <= p->endPosition(); ++i )
 		{
-			cur_start -= p->startPosition();
+			_timeline.addEvent( start + notes[i]->pos(), p,
+							notes[i], i );
 		}
-		if( p->isFrozen() && !engine::getSong()->isExporting() )
-		{
-			if( cur_start > 0 )
-			{
-				continue;
-			}
+	}
+}
 
-			SamplePlayHandle* handle = new SamplePlayHandle( p );
-			handle->setBBTrack( bb_track );
-			handle->setOffset( _offset );
-			// send it to the mixer
-			engine::mixer()->addPlayHandle( handle );
-			played_a_note = true;
-			continue;
-		}
 
-		// get all notes from the given pattern...
-		const NoteVector & notes = p->notes();
-		// ...and set our index to zero
-		NoteVector::ConstIterator nit = notes.begin();
-#if LMMS_SINGERBOT_SUPPORT
-		int note_idx = 0;
-#endif
 
-		// very effective algorithm for playing notes that are
-		// posated within the current sample-frame
 
+void InstrumentTrack::playFrozenPattern( pattern * _p, bbTrack * _bb_track,
+							const f_cnt_t _offset )
+{
+	SamplePlayHandle * handle = new SamplePlayHandle( _p );
+	handle->setBBTrack( _bb_track );
+	handle->setOffset( _offset );
+	// send it to the mixer
+	engine::mixer()->addPlayHandle( handle );
+}
 
-		if( cur_start > 0 )
-		{
-			// skip notes which are posated before start-tact
-			while( nit != notes.end() && ( *nit )->pos() < cur_start )
-			{
-#if LMMS_SINGERBOT_SUPPORT
-				if( ( *nit )->length() != 0 )
-				{
-					++note_idx;
-				}
-#endif
-				++nit;
-			}
-		}
 
-		note * cur_note;
-		while( nit != notes.end() &&
-					( cur_note = *nit )->pos() == cur_start )
-		{
-			if( cur_note->length() != 0 )
-			{
-				const f_cnt_t note_frames =
-					cur_note->length().frames(
-							frames_per_tick );
 
-				notePlayHandle * note_play_handle =
-					new notePlayHandle( this, _offset,
-								note_frames,
-								*cur_note );
-				note_play_handle->setBBTrack( bb_track );
-				// are we playing global song?
-				if( _tco_num < 0 )
-				{
-					// then set song-global offset of pattern in order to
-					// properly perform the note detuning
-					note_play_handle->setSongGlobalParentOffset( p->startPosition() );
-				}
+
+bool InstrumentTrack::startNote( pattern * _p, int _note_idx,
+				bbTrack * _bb_track, const f_cnt_t _offset,
+							const bool _in_song )
+{
+	const note * n = _p->notes()[_note_idx];
+	if( n->length() == 0 )
+	{
+		return false;
+	}
+
+	const f_cnt_t note_frames = n->length().frames(
+						engine::framesPerTick() );
+
+	notePlayHandle * note_play_handle =
+		new notePlayHandle( this, _offset, note_frames, *n );
+	note_play_handle->setBBTrack( _bb_track );
+	// are we playing global song?
+	if( _in_song )
+	{
+		// then set song-global offset of pattern in order to
+		// properly perform the note detuning
+		note_play_handle->setSongGlobalParentOffset(
+							_p->startPosition() );
+	}
 
 #if LMMS_SINGERBOT_SUPPORT
-				note_play_handle->setPatternIndex( note_idx );
-#endif
-				engine::mixer()->addPlayHandle(
-							note_play_handle );
-				played_a_note = true;
-#if LMMS_SINGERBOT_SUPPORT
-				++note_idx;
-#endif
-			}
-			++nit;
+	int pattern_idx = 0;
+	for( int i = 0; i < _note_idx; ++i )
+	{
+		if( _p->notes()[i]->length() != 0 )
+		{
+			++pattern_idx;
 		}
 	}
-	return played_a_note;
+	note_play_handle->setPatternIndex( pattern_idx );
+#endif
+	engine::mixer()->addPlayHandle( note_play_handle );
+	return true;
 }
 
 
@@ -852,6 +920,13 @@ InstrumentTrackView::InstrumentTrackView( InstrumentTrack * _it, TrackContainerV
 	m_panningKnob->setLabel( tr( "PAN" ) );
 	m_panningKnob->show();
 
+	// CPU time spent on this track in last period - between activity
+	// indicator and volume knob
+	RenderLoadMeter * rlm = new RenderLoadMeter( getTrackSettingsWidget(),
+						&_it->audioPort()->profile() );
+	rlm->move( widgetWidth-2*24-5, 4 );
+	rlm->show();
+
 	m_midiMenu = new QMenu( tr( "MIDI" ), this );
 
 	// sequenced MIDI?
@@ -893,7 +968,7 @@ InstrumentTrackView::InstrumentTrackView( InstrumentTrack * _it, TrackContainerV
 							QPalette::BrightText ),
 						getTrackSettingsWidget() );
 	m_activityIndicator->setGeometry(
-					 widgetWidth-2*24-11, 2, 8, 28 );
+					 widgetWidth-2*24-11, 2, 5, 28 );
 	m_activityIndicator->show();
 	connect( m_activityIndicator, SIGNAL( pressed() ),
 				this, SLOT( activityIndicatorPressed() ) );
@@ -406,20 +406,27 @@ SampleTrack::~SampleTrack()
 
 
 
-bool SampleTrack::play( const MidiTime & _start, const fpp_t _frames,
+void SampleTrack::setName( const QString & _new_name )
+{
+	track::setName( _new_name );
+	m_audioPort.setName( name() );
+}
+
+
+
+
+bool SampleTrack::play( const MidiTime & _start, const MidiTime & _end,
 						const f_cnt_t _offset, int /*_tco_num*/ )
 {
 	m_audioPort.effects()->startRunning();
 	bool played_a_note = false;	// will be return variable
 
-	for( int i = 0; i < numOfTCOs(); ++i )
+	const EventTimeline & tl = timeline();
+	const EventTimeline::EventVector & events = tl.events();
+	for( int i = tl.firstEventFrom( _start );
+				i < events.size() && events[i].pos < _end; ++i )
 	{
-		trackContentObject * tco = getTCO( i );
-		if( tco->startPosition() != _start )
-		{
-			continue;
-		}
-		SampleTCO * st = dynamic_cast<SampleTCO *>( tco );
+		SampleTCO * st = static_cast<SampleTCO *>( events[i].tco );
 		if( !st->isMuted() )
 		{
 			playHandle * handle;
@@ -440,7 +447,9 @@ bool SampleTrack::play( const MidiTime & _start, const fpp_t _frames,
 			}
 //TODO: check whether this works
 //			handle->setBBTrack( _tco_num );
-			handle->setOffset( _offset );
+			handle->setOffset( _offset +
+				MidiTime( events[i].pos - _start ).frames(
+						engine::framesPerTick() ) );
 			// send it to the mixer
 			engine::mixer()->addPlayHandle( handle );
 			played_a_note = true;
@@ -453,6 +462,18 @@ bool SampleTrack::play( const MidiTime & _start, const fpp_t _frames,
 
 
 
+void SampleTrack::compileTimeline( EventTimeline & _timeline )
+{
+	const tcoVector & tcos = getTCOs();
+	for( tcoVector::ConstIterator it = tcos.begin(); it != tcos.end(); ++it )
+	{
+		_timeline.addEvent( ( *it )->startPosition(), *it );
+	}
+}
+
+
+
+
 trackView * SampleTrack::createView( TrackContainerView* tcv )
 {
 	return new SampleTrackView( this, tcv );
@@ -341,7 +341,7 @@ bbTrack::~bbTrack()
 
 
 // play _frames frames of given TCO within starting with _start
-bool bbTrack::play( const MidiTime & _start, const fpp_t _frames,
+bool bbTrack::play( const MidiTime & _start, const MidiTime & _end,
 					const f_cnt_t _offset, int _tco_num )
 {
 	if( isMuted() )
@@ -351,34 +351,45 @@ bool bbTrack::play( const MidiTime & _start, const fpp_t _frames,
 
 	if( _tco_num >= 0 )
 	{
-		return engine::getBBTrackContainer()->play( _start, _frames, _offset, s_infoMap[this] );
+		return engine::getBBTrackContainer()->play( _start, _end, _offset, s_infoMap[this] );
 	}
 
-	tcoVector tcos;
-	getTCOsInRange( tcos, _start, _start + static_cast<int>( _frames / engine::framesPerTick() ) );
-
-	if( tcos.size() == 0 )
+	// TCOs may start or end anywhere within range, so find out which one
+	// to play for every tick
+	const float frames_per_tick = engine::framesPerTick();
+	bool played_a_note = false;
+	for( tick_t t = _start; t < _end; ++t )
 	{
-		return false;
-	}
+		tcoVector tcos;
+		getTCOsInRange( tcos, t, t );
 
-	MidiTime lastPosition;
-	MidiTime lastLen;
-	for( tcoVector::iterator it = tcos.begin(); it != tcos.end(); ++it )
-	{
-		if( !( *it )->isMuted() &&
-				( *it )->startPosition() >= lastPosition )
+		if( tcos.size() == 0 )
 		{
-			lastPosition = ( *it )->startPosition();
-			lastLen = ( *it )->length();
+			continue;
 		}
-	}
 
-	if( _start - lastPosition < lastLen )
-	{
-		return engine::getBBTrackContainer()->play( _start - lastPosition, _frames, _offset, s_infoMap[this] );
+		MidiTime lastPosition;
+		MidiTime lastLen;
+		for( tcoVector::iterator it = tcos.begin(); it != tcos.end(); ++it )
+		{
+			if( !( *it )->isMuted() &&
+					( *it )->startPosition() >= lastPosition )
+			{
+				lastPosition = ( *it )->startPosition();
+				lastLen = ( *it )->length();
+			}
+		}
+
+		if( t - lastPosition < lastLen &&
+			engine::getBBTrackContainer()->play( t - lastPosition,
+					t - lastPosition + 1, _offset +
+					MidiTime( t - _start ).frames( frames_per_tick ),
+							s_infoMap[this] ) )
+		{
+			played_a_note = true;
+		}
 	}
-	return false;
+	return played_a_note;
 }
 
 
@@ -63,6 +63,7 @@ pattern::pattern( InstrumentTrack * _instrument_track ) :
 	trackContentObject( _instrument_track ),
 	m_instrumentTrack( _instrument_track ),
 	m_patternType( BeatPattern ),
+	m_noteCursor( 0 ),
 	m_steps( MidiTime::stepsPerTact() ),
 	m_frozenPattern( NULL ),
 	m_freezing( false ),
@@ -79,6 +80,7 @@ pattern::pattern( const pattern & _pat_to_copy ) :
 	trackContentObject( _pat_to_copy.m_instrumentTrack ),
 	m_instrumentTrack( _pat_to_copy.m_instrumentTrack ),
 	m_patternType( _pat_to_copy.m_patternType ),
+	m_noteCursor( 0 ),
 	m_steps( _pat_to_copy.m_steps ),
 	m_frozenPattern( NULL ),
 	m_freezeAborted( false )
@@ -211,6 +213,7 @@ note * pattern::addNote( const note & _new_note, const bool _quant_pos )
 
 		m_notes.insert( it, new_note );
 	}
+	m_instrumentTrack->invalidateTimeline();
 	engine::mixer()->unlock();
 
 	checkType();
@@ -240,6 +243,7 @@ void pattern::removeNote( const note * _note_to_del )
 		}
 		++it;
 	}
+	m_instrumentTrack->invalidateTimeline();
 	engine::mixer()->unlock();
 
 	checkType();
@@ -270,6 +274,23 @@ void pattern::rearrangeAllNotes()
 {
 	// sort notes by start time	
 	qSort(m_notes.begin(), m_notes.end(), note::lessThan );
+	m_instrumentTrack->invalidateTimeline();
+}
+
+
+
+
+static tick_t notePos( note * const & _n )
+{
+	return _n->pos();
+}
+
+
+
+
+int pattern::firstNoteFrom( const MidiTime & _pos ) const
+{
+	return tFirstFrom( m_notes, (tick_t) _pos, m_noteCursor, notePos );
 }
 
 
@@ -283,6 +304,7 @@ void pattern::clearNotes()
 		delete *it;
 	}
 	m_notes.clear();
+	m_instrumentTrack->invalidateTimeline();
 	engine::mixer()->unlock();
 
 	checkType();
@@ -405,6 +427,7 @@ void pattern::loadSettings( const QDomElement & _this )
 		}
 		node = node.nextSibling();
         }
+	m_instrumentTrack->invalidateTimeline();
 
 	m_steps = _this.attribute( "steps" ).toInt();
 	if( m_steps == 0 )